@@ -19,6 +19,644 @@
 #include <drv_gpio.h>
 #include <rtdef.h>
 #include <rtconfig.h>
+#include <rthw.h>
+
+/*
+ * 可选功能配置：以下宏可在 rtconfig.h 中或包含本文件之前定义。
+ *
+ * RTREPACK_USING_IPC_CAPTURE       记录库创建的 IPC 对象上的每一次操作，并支持重放
+ *   RTREPACK_IPC_CAPTURE_RECORDS   记录缓冲区条数
+ *   RTREPACK_IPC_CAPTURE_OBJECTS   可登记的对象数量
+ *   RTREPACK_IPC_CAPTURE_THREADS   可登记的线程数量（不超过 63）
+ *
+ * RTREPACK_USING_VIRTUAL_TIME      托管后端上的确定性虚拟时间：空闲时直接跳到下一个定时器到期
+ *   RTREPACK_VTIME_FREQ            虚拟时钟频率（Hz），即时间戳的分辨率
+ *
+ * RTREPACK_USING_BENCH             基准测试：竞争扩展性扫描与原语微基准，结果以 CSV 行输出到控制台
+ *   RTREPACK_BENCH_STACK_SIZE      基准测试线程栈大小
+ *
+ * RTREPACK_USING_SCHED_TRACE       线程切换时用几个 GPIO 输出当前线程编号或优先级，供逻辑分析仪采集
+ *   RTREPACK_THREAD_REGISTRY_SIZE  可登记编号的线程数量（编号 0 保留给未登记线程）
+ *
+ * RTREPACK_USING_PROFILER          定时中断采样剖析：采集被中断的 PC 与线程，输出按函数的平坦直方图
+ *   RTREPACK_PROFILER_RING         中断到汇总线程的无锁环形缓冲条数（2 的幂）
+ *   RTREPACK_PROFILER_SLOTS        汇总表条数（不同的 线程+PC 组合数）
+ *
+ * RTREPACK_USING_HEAP_MONITOR      按对象类型与名称前缀统计生成器动态分配的内存（当前/峰值）及堆碎片
+ *   RTREPACK_HEAP_MONITOR_OBJECTS  可同时跟踪的动态对象数量
+ *   RTREPACK_HEAP_MONITOR_PREFIXES 名称前缀统计表条数
+ *   RTREPACK_HEAP_MONITOR_PREFIX_LEN  前缀最大长度（取名称中第一个 '_' 或数字之前的部分）
+ *
+ * RTREPACK_USING_STATIC_POOLS      无堆配置：生成器的动态请求改由按类型划分、置于专用链接段的静态池提供
+ *   RTREPACK_POOL_SECTION          静态池所在的链接段名，链接脚本中应将其放入 RAM（NOLOAD）
+ *   RTREPACK_POOL_THREADS / RTREPACK_POOL_STACK_BYTES      线程控制块数 / 线程栈区总字节数
+ *   RTREPACK_POOL_SEMS / RTREPACK_POOL_MUTEXES / RTREPACK_POOL_EVENTS  各类控制块数
+ *   RTREPACK_POOL_MAILBOXES / RTREPACK_POOL_MB_BYTES      邮箱控制块数 / 邮箱池总字节数
+ *   RTREPACK_POOL_MQS / RTREPACK_POOL_MQ_BYTES            消息队列控制块数 / 消息池总字节数
+ *   RTREPACK_POOL_BLOCKS / RTREPACK_POOL_BLOCK_BYTES      库自身对象（天花板互斥量、环形队列等）的块数 / 总字节数
+ *   RTREPACK_POOL_BUDGET_BYTES     可选，静态池总字节数上限，超出时编译报错
+ *
+ * RTREPACK_USING_IPC_LATENCY       为生成器创建的邮箱与消息队列记录每条消息的排队时间，按对象统计延迟直方图
+ *   RTREPACK_IPC_LATENCY_OBJECTS   可统计的对象数量
+ *   RTREPACK_IPC_LATENCY_DEPTH     每个对象的时间戳旁路环条数，应不小于对象容量
+ *
+ * RTREPACK_USING_IPC_TRACE         追踪号随带时间戳的消息在流水线各线程间传递，记录采样工作每一跳的耗时（需 IPC_LATENCY）
+ *   RTREPACK_IPC_TRACE_SAMPLE      采样比例，每多少次 ipc_trace_begin 开启一次追踪
+ *   RTREPACK_IPC_TRACE_RECORDS     每跳记录缓冲区条数
+ *
+ * RTREPACK_USING_BALANCER          SMP 负载均衡：按各线程的 CPU 占用把未绑核的线程迁移到较闲的核
+ *   RTREPACK_BALANCE_PERIOD        均衡周期（ms）
+ *   RTREPACK_BALANCE_THRESHOLD     触发迁移的核间负载差（千分比）
+ *   RTREPACK_BALANCE_PERSIST       负载差须连续超过阈值的周期数
+ *   RTREPACK_BALANCE_COOLDOWN      同一线程两次迁移之间至少间隔的周期数
+ */
+#ifdef RTREPACK_USING_IPC_CAPTURE
+#ifndef RT_USING_HOOK
+#error "RTREPACK_USING_IPC_CAPTURE requires RT_USING_HOOK"
+#endif
+#ifndef RTREPACK_IPC_CAPTURE_RECORDS
+#define RTREPACK_IPC_CAPTURE_RECORDS 1024
+#endif
+#ifndef RTREPACK_IPC_CAPTURE_OBJECTS
+#define RTREPACK_IPC_CAPTURE_OBJECTS 16
+#endif
+#ifndef RTREPACK_IPC_CAPTURE_THREADS
+#define RTREPACK_IPC_CAPTURE_THREADS 16
+#endif
+#endif
+
+#ifdef RTREPACK_USING_VIRTUAL_TIME
+#if !defined(RT_USING_IDLE_HOOK) && !defined(RT_USING_HOOK)
+#error "RTREPACK_USING_VIRTUAL_TIME requires RT_USING_IDLE_HOOK"
+#endif
+#ifndef RTREPACK_VTIME_FREQ
+#define RTREPACK_VTIME_FREQ 1000000
+#endif
+#if (RTREPACK_VTIME_FREQ % RT_TICK_PER_SECOND) != 0
+#error "RTREPACK_VTIME_FREQ must be a multiple of RT_TICK_PER_SECOND"
+#endif
+/* 虚拟时钟（单位 1/RTREPACK_VTIME_FREQ 秒），由 vtime_consume 与空闲跳转推进 */
+static volatile rt_uint64_t vtime_now;
+void vtime_consume(rt_uint32_t duration);
+#ifndef RTREPACK_TIMESTAMP_GET
+#define RTREPACK_TIMESTAMP_GET()  ((rt_uint32_t)vtime_now)
+#define RTREPACK_TIMESTAMP_FREQ   RTREPACK_VTIME_FREQ
+#endif
+#endif
+
+#ifdef RTREPACK_USING_BENCH
+#ifndef RTREPACK_BENCH_STACK_SIZE
+#define RTREPACK_BENCH_STACK_SIZE 1024
+#endif
+#endif
+
+#ifdef RTREPACK_USING_SCHED_TRACE
+#ifndef RT_USING_HOOK
+#error "RTREPACK_USING_SCHED_TRACE requires RT_USING_HOOK"
+#endif
+#define RTREPACK_USING_THREAD_REGISTRY
+#define RTREPACK_USING_SCHED_HOOK
+#endif
+
+#ifdef RTREPACK_USING_PROFILER
+#ifndef RT_USING_HOOK
+#error "RTREPACK_USING_PROFILER requires RT_USING_HOOK"
+#endif
+#ifndef RTREPACK_PROFILER_RING
+#define RTREPACK_PROFILER_RING 256
+#endif
+#if (RTREPACK_PROFILER_RING & (RTREPACK_PROFILER_RING - 1)) != 0
+#error "RTREPACK_PROFILER_RING must be a power of two"
+#endif
+#ifndef RTREPACK_PROFILER_SLOTS
+#define RTREPACK_PROFILER_SLOTS 512
+#endif
+#define RTREPACK_USING_THREAD_REGISTRY
+#endif
+
+#ifdef RTREPACK_USING_HEAP_MONITOR
+#if !defined(RT_USING_HOOK) || !defined(RT_USING_HEAP)
+#error "RTREPACK_USING_HEAP_MONITOR requires RT_USING_HOOK and RT_USING_HEAP"
+#endif
+#ifndef RTREPACK_HEAP_MONITOR_OBJECTS
+#define RTREPACK_HEAP_MONITOR_OBJECTS 64
+#endif
+#ifndef RTREPACK_HEAP_MONITOR_PREFIXES
+#define RTREPACK_HEAP_MONITOR_PREFIXES 16
+#endif
+#ifndef RTREPACK_HEAP_MONITOR_PREFIX_LEN
+#define RTREPACK_HEAP_MONITOR_PREFIX_LEN 4
+#endif
+#define RTREPACK_USING_DETACH_HOOK
+#endif
+
+#ifdef RTREPACK_USING_STATIC_POOLS
+#ifndef RT_USING_HOOK
+#error "RTREPACK_USING_STATIC_POOLS requires RT_USING_HOOK"
+#endif
+#ifndef RTREPACK_POOL_SECTION
+#define RTREPACK_POOL_SECTION ".rtrepack_pool"
+#endif
+#ifndef RTREPACK_POOL_THREADS
+#define RTREPACK_POOL_THREADS 8
+#endif
+#ifndef RTREPACK_POOL_STACK_BYTES
+#define RTREPACK_POOL_STACK_BYTES 8192
+#endif
+#ifndef RTREPACK_POOL_SEMS
+#define RTREPACK_POOL_SEMS 8
+#endif
+#ifndef RTREPACK_POOL_MUTEXES
+#define RTREPACK_POOL_MUTEXES 8
+#endif
+#ifndef RTREPACK_POOL_EVENTS
+#define RTREPACK_POOL_EVENTS 4
+#endif
+#ifndef RTREPACK_POOL_MAILBOXES
+#define RTREPACK_POOL_MAILBOXES 4
+#endif
+#ifndef RTREPACK_POOL_MB_BYTES
+#define RTREPACK_POOL_MB_BYTES 256
+#endif
+#ifndef RTREPACK_POOL_MQS
+#define RTREPACK_POOL_MQS 4
+#endif
+#ifndef RTREPACK_POOL_MQ_BYTES
+#define RTREPACK_POOL_MQ_BYTES 1024
+#endif
+#ifndef RTREPACK_POOL_BLOCKS
+#define RTREPACK_POOL_BLOCKS 8
+#endif
+#ifndef RTREPACK_POOL_BLOCK_BYTES
+#define RTREPACK_POOL_BLOCK_BYTES 2048
+#endif
+#define RTREPACK_USING_DETACH_HOOK
+#endif
+
+#ifdef RTREPACK_USING_IPC_LATENCY
+#ifndef RT_USING_HOOK
+#error "RTREPACK_USING_IPC_LATENCY requires RT_USING_HOOK"
+#endif
+#ifndef RTREPACK_IPC_LATENCY_OBJECTS
+#define RTREPACK_IPC_LATENCY_OBJECTS 8
+#endif
+#ifndef RTREPACK_IPC_LATENCY_DEPTH
+#define RTREPACK_IPC_LATENCY_DEPTH 64
+#endif
+#define RTREPACK_USING_DETACH_HOOK
+#endif
+
+#ifdef RTREPACK_USING_IPC_TRACE
+#ifndef RTREPACK_USING_IPC_LATENCY
+#error "RTREPACK_USING_IPC_TRACE requires RTREPACK_USING_IPC_LATENCY"
+#endif
+#ifndef RTREPACK_IPC_TRACE_SAMPLE
+#define RTREPACK_IPC_TRACE_SAMPLE 16
+#endif
+#ifndef RTREPACK_IPC_TRACE_RECORDS
+#define RTREPACK_IPC_TRACE_RECORDS 256
+#endif
+#define RTREPACK_USING_THREAD_REGISTRY
+#endif
+
+#ifdef RTREPACK_USING_BALANCER
+#if !defined(RT_USING_HOOK) || !defined(RT_USING_SMP)
+#error "RTREPACK_USING_BALANCER requires RT_USING_HOOK and RT_USING_SMP"
+#endif
+#ifndef RTREPACK_BALANCE_PERIOD
+#define RTREPACK_BALANCE_PERIOD 100
+#endif
+#ifndef RTREPACK_BALANCE_THRESHOLD
+#define RTREPACK_BALANCE_THRESHOLD 200
+#endif
+#ifndef RTREPACK_BALANCE_PERSIST
+#define RTREPACK_BALANCE_PERSIST 3
+#endif
+#ifndef RTREPACK_BALANCE_COOLDOWN
+#define RTREPACK_BALANCE_COOLDOWN 20
+#endif
+#define RTREPACK_USING_THREAD_REGISTRY
+#define RTREPACK_USING_SCHED_HOOK
+#endif
+
+#ifdef RTREPACK_USING_THREAD_REGISTRY
+#ifndef RTREPACK_THREAD_REGISTRY_SIZE
+#define RTREPACK_THREAD_REGISTRY_SIZE 15
+#endif
+#endif
+
+/* 线程登记表与记录对象表只在对象脱离/删除时撤销登记，否则会残留已释放的控制块 */
+#if defined(RTREPACK_USING_THREAD_REGISTRY) || defined(RTREPACK_USING_IPC_CAPTURE)
+#ifndef RT_USING_HOOK
+#error "RTREPACK_USING_THREAD_REGISTRY and RTREPACK_USING_IPC_CAPTURE require RT_USING_HOOK"
+#endif
+#define RTREPACK_USING_DETACH_HOOK
+#endif
+
+/*
+ * 时间戳：Cortex-M3/M4/M7 等带 DWT 的内核使用 CYCCNT 周期计数器，
+ * 其余平台退化为系统节拍。也可自行定义 RTREPACK_TIMESTAMP_GET() 与 RTREPACK_TIMESTAMP_FREQ。
+ */
+#if !defined(RTREPACK_TIMESTAMP_GET) && defined(DWT_CTRL_CYCCNTENA_Msk)
+#define RTREPACK_TIMESTAMP_USING_DWT
+#endif
+
+/**
+ * @brief  使能时间戳计数器，使用时间戳的功能在启动前调用一次即可。
+ */
+rt_inline void repack_timestamp_init(void)
+{
+#ifdef RTREPACK_TIMESTAMP_USING_DWT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+/**
+ * @brief  读取当前时间戳（32 位回绕，差值用无符号减法计算）。
+ */
+rt_inline rt_uint32_t repack_timestamp_get(void)
+{
+#if defined(RTREPACK_TIMESTAMP_GET)
+    return RTREPACK_TIMESTAMP_GET();
+#elif defined(RTREPACK_TIMESTAMP_USING_DWT)
+    return DWT->CYCCNT;
+#else
+    return rt_tick_get();
+#endif
+}
+
+/**
+ * @brief  时间戳的计数频率（Hz）。
+ */
+rt_inline rt_uint32_t repack_timestamp_freq(void)
+{
+#if defined(RTREPACK_TIMESTAMP_GET)
+    return RTREPACK_TIMESTAMP_FREQ;
+#elif defined(RTREPACK_TIMESTAMP_USING_DWT)
+    return SystemCoreClock;
+#else
+    return RT_TICK_PER_SECOND;
+#endif
+}
+
+/* 时间戳差值换算为微秒 */
+rt_inline rt_uint32_t repack_timestamp_to_us(rt_uint32_t delta, rt_uint32_t freq)
+{
+    return (rt_uint32_t)(((rt_uint64_t)delta * 1000000ULL) / freq);
+}
+
+/*
+ * 延迟直方图：按 2 的幂分桶，第 k 桶覆盖 [2^k, 2^(k+1))，0 计入第 0 桶。
+ * 记录只做一次前导零计数与一次自增，适合放在热路径上；并发写入时由调用方保证互斥。
+ */
+#define REPACK_HIST_BUCKETS 32
+
+struct repack_hist
+{
+    rt_uint32_t buckets[REPACK_HIST_BUCKETS];
+    rt_uint32_t count;
+    rt_uint32_t max;
+    rt_uint64_t sum;
+};
+
+rt_inline rt_uint8_t repack_hist_bucket(rt_uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return value ? (rt_uint8_t)(31 - __builtin_clz(value)) : 0;
+#else
+    rt_uint8_t k = 0;
+
+    while (value >>= 1)
+        k++;
+    return k;
+#endif
+}
+
+rt_inline void repack_hist_add(struct repack_hist *hist, rt_uint32_t value)
+{
+    hist->buckets[repack_hist_bucket(value)]++;
+    hist->count++;
+    hist->sum += value;
+    if (value > hist->max)
+        hist->max = value;
+}
+
+/* 把 src 合并进 dst，用于各线程私有直方图的汇总 */
+rt_inline void repack_hist_merge(struct repack_hist *dst, const struct repack_hist *src)
+{
+    rt_uint8_t i;
+
+    for (i = 0; i < REPACK_HIST_BUCKETS; i++)
+        dst->buckets[i] += src->buckets[i];
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if (src->max > dst->max)
+        dst->max = src->max;
+}
+
+/**
+ * @brief  估算百分位数，返回所在桶的上界（不超过记录到的最大值）。
+ *
+ * @param[in] permille  千分位，如 500 为中位数，990 为 p99，999 为 p99.9。
+ */
+rt_inline rt_uint32_t repack_hist_percentile(const struct repack_hist *hist, rt_uint32_t permille)
+{
+    rt_uint64_t target = ((rt_uint64_t)hist->count * permille + 999) / 1000;
+    rt_uint64_t seen = 0;
+    rt_uint8_t i;
+
+    for (i = 0; i < REPACK_HIST_BUCKETS && hist->count; i++)
+    {
+        seen += hist->buckets[i];
+        if (seen >= target)
+        {
+            rt_uint32_t upper = (i >= 31) ? RT_UINT32_MAX : ((2UL << i) - 1);
+            return (upper < hist->max) ? upper : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+/*
+ * 库自身类型（控制块与其缓冲区）的动态内存：启用静态池时与内核对象一样由静态池提供，
+ * 否则使用堆；既无堆也无静态池时动态创建一律按内存不足失败。
+ */
+#if defined(RTREPACK_USING_STATIC_POOLS)
+#define repack_malloc(size)  repack_pool_malloc(size)
+#define repack_free(ptr)     repack_pool_free(ptr)
+#elif defined(RT_USING_HEAP)
+#define repack_malloc(size)  rt_malloc(size)
+#define repack_free(ptr)     rt_free(ptr)
+#else
+#define repack_malloc(size)  ((void)(size), RT_NULL)
+#define repack_free(ptr)     ((void)(ptr))
+#endif
+
+/* rt_mq 内部每条消息前的链表头（与内核 struct rt_mq_message 布局一致，5.x 起增加了长度字段） */
+struct repack_mq_message
+{
+    struct repack_mq_message *next;
+#if defined(RT_VERSION_MAJOR) && (RT_VERSION_MAJOR >= 5)
+    rt_ssize_t length;
+#ifdef RT_USING_MESSAGEQUEUE_PRIORITY
+    rt_int32_t prio;
+#endif
+#endif
+};
+#ifndef REPACK_MQ_MSG_HDR_SIZE
+#define REPACK_MQ_MSG_HDR_SIZE sizeof(struct repack_mq_message)
+#endif
+/*
+ * 5.1 起内核在 rtdef.h 公开 struct rt_mq_message（同时提供 RT_MQ_BUF_SIZE），可在编译期核对；
+ * 更早的版本该结构体私有于 ipc.c，只能在初始化时核对 rt_mq_init 算出的容量（见各生成器中的断言）。
+ */
+#if defined(RT_USING_MESSAGEQUEUE) && defined(RT_MQ_BUF_SIZE)
+typedef char repack_mq_message_check[(REPACK_MQ_MSG_HDR_SIZE == sizeof(struct rt_mq_message)) ? 1 : -1];
+#endif
+
+/*
+ * 32 位原子操作。带 LDREX/STREX 的内核（及非 ARM 平台）使用编译器内建原子操作，
+ * Cortex-M0 等没有独占访问指令的内核退化为关中断实现。
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && (!defined(__arm__) || defined(__ARM_FEATURE_LDREX))
+#define REPACK_ATOMIC_BUILTIN
+#endif
+
+/* 比较并交换：*ptr 等于 expected 时写入 desired 并返回 RT_TRUE */
+rt_inline rt_bool_t repack_atomic_cas(volatile rt_uint32_t *ptr, rt_uint32_t expected, rt_uint32_t desired)
+{
+#ifdef REPACK_ATOMIC_BUILTIN
+    return __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ? RT_TRUE : RT_FALSE;
+#else
+    rt_base_t level = rt_hw_interrupt_disable();
+    rt_bool_t ok = (*ptr == expected);
+
+    if (ok)
+        *ptr = desired;
+    rt_hw_interrupt_enable(level);
+    return ok;
+#endif
+}
+
+/* 交换：写入 value 并返回原值 */
+rt_inline rt_uint32_t repack_atomic_xchg(volatile rt_uint32_t *ptr, rt_uint32_t value)
+{
+#ifdef REPACK_ATOMIC_BUILTIN
+    return __atomic_exchange_n(ptr, value, __ATOMIC_ACQ_REL);
+#else
+    rt_base_t level = rt_hw_interrupt_disable();
+    rt_uint32_t old = *ptr;
+
+    *ptr = value;
+    rt_hw_interrupt_enable(level);
+    return old;
+#endif
+}
+
+/* 加法：返回相加前的值 */
+rt_inline rt_uint32_t repack_atomic_add(volatile rt_uint32_t *ptr, rt_uint32_t value)
+{
+#ifdef REPACK_ATOMIC_BUILTIN
+    return __atomic_fetch_add(ptr, value, __ATOMIC_ACQ_REL);
+#else
+    rt_base_t level = rt_hw_interrupt_disable();
+    rt_uint32_t old = *ptr;
+
+    *ptr = old + value;
+    rt_hw_interrupt_enable(level);
+    return old;
+#endif
+}
+
+/* 获取语义的读取，与另一方释放语义的写入配对 */
+rt_inline rt_uint32_t repack_atomic_load(const volatile rt_uint32_t *ptr)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#else
+    return *ptr;
+#endif
+}
+
+/* 释放语义的写入：此前的写入对读到该值的一方可见 */
+rt_inline void repack_atomic_store(volatile rt_uint32_t *ptr, rt_uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#else
+    *ptr = value;
+#endif
+}
+
+/* 全屏障：先写自己的标志再读对方的标志时使用 */
+rt_inline void repack_atomic_fence(void)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+/* 无序加法：只保证本次加法的原子性，用于统计计数 */
+rt_inline void repack_atomic_add_relaxed(volatile rt_uint32_t *ptr, rt_uint32_t value)
+{
+#ifdef REPACK_ATOMIC_BUILTIN
+    __atomic_fetch_add(ptr, value, __ATOMIC_RELAXED);
+#else
+    rt_base_t level = rt_hw_interrupt_disable();
+
+    *ptr += value;
+    rt_hw_interrupt_enable(level);
+#endif
+}
+
+/* 核数与当前核编号，非 SMP 时为单核 */
+#ifdef RT_USING_SMP
+#define RTREPACK_CPUS_NR RT_CPUS_NR
+#define repack_cpu_id()  ((rt_uint8_t)rt_hw_cpu_id())
+#else
+#define RTREPACK_CPUS_NR 1
+#define repack_cpu_id()  ((rt_uint8_t)0)
+#endif
+
+/*
+ * 库内部的短临界区。单核时即关中断；SMP 下 rt_hw_interrupt_disable 只屏蔽本核，
+ * 跨核共享的空闲链表、环形队列下标等改用自旋锁（同时关本核中断）保护。
+ */
+#ifdef RT_USING_SMP
+typedef struct rt_spinlock repack_lock_t;
+#define repack_lock_init(lock)      rt_spin_lock_init(lock)
+#define repack_lock(lock)           rt_spin_lock_irqsave(lock)
+#define repack_unlock(lock, level)  rt_spin_unlock_irqrestore(lock, level)
+#else
+typedef rt_uint8_t repack_lock_t;
+#define repack_lock_init(lock)      ((void)(lock))
+#define repack_lock(lock)           ((void)(lock), rt_hw_interrupt_disable())
+#define repack_unlock(lock, level)  ((void)(lock), rt_hw_interrupt_enable(level))
+#endif
+
+/* 缓存行大小，用于把各核独占的数据分开，避免伪共享 */
+#ifndef RTREPACK_CACHE_LINE
+#define RTREPACK_CACHE_LINE 64
+#endif
+
+#ifdef RTREPACK_USING_STATIC_POOLS
+#define REPACK_POOL_THREAD   0
+#define REPACK_POOL_SEM      1
+#define REPACK_POOL_MUTEX    2
+#define REPACK_POOL_EVENT    3
+#define REPACK_POOL_MAILBOX  4
+#define REPACK_POOL_MQ       5
+#define REPACK_POOL_BLOCK    6   /* 库自身对象：没有控制块数组，整块内存即缓冲区 */
+#define REPACK_POOL_KINDS    7
+
+static void *repack_pool_alloc(rt_uint8_t kind, void **region, rt_size_t region_size);
+static rt_bool_t repack_pool_owns(const void *object);
+static void *repack_pool_malloc(rt_size_t size);
+static void repack_pool_free(void *ptr);
+#endif /* RTREPACK_USING_STATIC_POOLS */
+
+/*
+ * 删除生成器动态创建的对象。启用静态池时动态创建的对象可能来自池中，
+ * 这类对象是静态对象，只能脱离（槽位经对象脱离钩子归还），其余对象走内核删除函数。
+ */
+#if defined(RTREPACK_USING_STATIC_POOLS) && defined(RT_USING_HEAP)
+#define REPACK_DELETE_DEFINE(kind, type, del, detach)          \
+    rt_inline rt_err_t repack_##kind##_delete(type obj)        \
+    {                                                          \
+        return repack_pool_owns(obj) ? detach(obj) : del(obj); \
+    }
+#elif defined(RTREPACK_USING_STATIC_POOLS)
+#define REPACK_DELETE_DEFINE(kind, type, del, detach)          \
+    rt_inline rt_err_t repack_##kind##_delete(type obj)        \
+    {                                                          \
+        return detach(obj);                                    \
+    }
+#elif defined(RT_USING_HEAP)
+#define REPACK_DELETE_DEFINE(kind, type, del, detach)          \
+    rt_inline rt_err_t repack_##kind##_delete(type obj)        \
+    {                                                          \
+        return del(obj);                                       \
+    }
+#endif
+#ifdef REPACK_DELETE_DEFINE
+REPACK_DELETE_DEFINE(thread, rt_thread_t, rt_thread_delete, rt_thread_detach)
+REPACK_DELETE_DEFINE(sem, rt_sem_t, rt_sem_delete, rt_sem_detach)
+REPACK_DELETE_DEFINE(mutex, rt_mutex_t, rt_mutex_delete, rt_mutex_detach)
+REPACK_DELETE_DEFINE(event, rt_event_t, rt_event_delete, rt_event_detach)
+REPACK_DELETE_DEFINE(mb, rt_mailbox_t, rt_mb_delete, rt_mb_detach)
+REPACK_DELETE_DEFINE(mq, rt_mq_t, rt_mq_delete, rt_mq_detach)
+#endif
+
+/*
+ * 静态线程对象是否仍在内核对象链表中。线程函数返回后，5.x 要等空闲线程回收时才脱离对象，
+ * 在此之前对同一控制块再次 rt_thread_init 会破坏对象链表；脱离后对象类型被清零。
+ */
+rt_inline rt_bool_t repack_thread_listed(rt_thread_t thread)
+{
+    return (rt_object_get_type((rt_object_t)thread) == RT_Object_Class_Thread) ? RT_TRUE : RT_FALSE;
+}
+
+/*
+ * 线程调度字段。5.1 起优先级、时间片与绑核移入 RT_SCHED_PRIV / RT_SCHED_CTX，由调度器锁保护；
+ * 更早的版本直接位于 struct rt_thread，节拍中断在关中断（SMP 下即全局 cpus 锁）区内修改。
+ */
+#ifdef RT_SCHED_PRIV
+#define repack_thread_init_priority(thread)   (RT_SCHED_PRIV(thread).init_priority)
+#define repack_thread_cur_priority(thread)    (RT_SCHED_PRIV(thread).current_priority)
+#define repack_thread_init_tick(thread)       (RT_SCHED_PRIV(thread).init_tick)
+#define repack_thread_remaining_tick(thread)  (RT_SCHED_PRIV(thread).remaining_tick)
+#define repack_thread_bind_cpu(thread)        (RT_SCHED_CTX(thread).bind_cpu)
+typedef rt_sched_lock_level_t repack_sched_level_t;
+#define repack_sched_lock(level)              rt_sched_lock(&(level))
+#define repack_sched_unlock(level)            rt_sched_unlock(level)
+#else
+#define repack_thread_init_priority(thread)   ((thread)->init_priority)
+#define repack_thread_cur_priority(thread)    ((thread)->current_priority)
+#define repack_thread_init_tick(thread)       ((thread)->init_tick)
+#define repack_thread_remaining_tick(thread)  ((thread)->remaining_tick)
+#define repack_thread_bind_cpu(thread)        ((thread)->bind_cpu)
+typedef rt_base_t repack_sched_level_t;
+#define repack_sched_lock(level)              ((level) = rt_hw_interrupt_disable())
+#define repack_sched_unlock(level)            rt_hw_interrupt_enable(level)
+#endif
+
+/* 生成器创建对象成功后的统一登记点，由各可选功能在本文件后部实现 */
+static void repack_object_created(rt_object_t object, rt_bool_t is_dynamic);
+
+/*
+ * 库自身类型在堆监视中的类别，排在内核对象类型之后。
+ * 这些类型动态创建成功后按实际分配的字节数（控制块 + 一并分配的缓冲区）登记一次，删除时在释放前撤销；
+ * 其中内嵌的内核对象按静态对象交给 repack_object_created，不再重复计入。
+ */
+#define REPACK_HEAP_CEILING_MUTEX   (RT_Object_Class_MessageQueue + 1)
+#define REPACK_HEAP_LITE_MUTEX      (RT_Object_Class_MessageQueue + 2)
+#define REPACK_HEAP_SHARDED_MQ      (RT_Object_Class_MessageQueue + 3)
+#define REPACK_HEAP_IO_RING         (RT_Object_Class_MessageQueue + 4)
+#define REPACK_HEAP_DMA_POOL        (RT_Object_Class_MessageQueue + 5)
+#define REPACK_HEAP_TRIPLE_BUFFER   (RT_Object_Class_MessageQueue + 6)
+#define REPACK_HEAP_INPLACE_MQ      (RT_Object_Class_MessageQueue + 7)
+#define REPACK_HEAP_SEM_CACHE       (RT_Object_Class_MessageQueue + 8)
+#define REPACK_HEAP_COMPLETION      (RT_Object_Class_MessageQueue + 9)
+#define REPACK_HEAP_STREAM_BUFFER   (RT_Object_Class_MessageQueue + 10)
+#define REPACK_HEAP_GPIO_DISPATCHER (RT_Object_Class_MessageQueue + 11)
+#define REPACK_HEAP_KINDS           (RT_Object_Class_MessageQueue + 12)
+
+#ifdef RTREPACK_USING_HEAP_MONITOR
+static void heap_monitor_tag(const void *ptr, rt_size_t bytes, rt_uint8_t kind, const char *name);
+static void heap_monitor_untag(const void *ptr);
+#endif
+/* 启用静态池时库自身类型取自块池而非堆，不登记 */
+#if defined(RTREPACK_USING_HEAP_MONITOR) && !defined(RTREPACK_USING_STATIC_POOLS)
+#define repack_heap_tag(ptr, bytes, kind, name)  heap_monitor_tag(ptr, bytes, kind, name)
+#define repack_heap_untag(ptr)                   heap_monitor_untag(ptr)
+#else
+#define repack_heap_tag(ptr, bytes, kind, name)  ((void)(ptr), (void)(bytes), (void)(name))
+#define repack_heap_untag(ptr)                   ((void)(ptr))
+#endif
+#ifdef RT_USING_HOOK
+static void repack_detach_hook_install(void);
+#endif
 
 /**
  * @brief  创建或初始化一个信号量，支持动态和静态创建。
@@ -42,7 +680,7 @@
  *         - 非 `RT_EOK`：静态创建失败。
  *
  * @note  若使用动态创建信号量（`is_dynamic` 为 `RT_TRUE`），
- *        用户需在信号量不再使用时调用 `rt_sem_delete` 释放内存。
+ *        用户需在信号量不再使用时调用 `repack_sem_delete` 释放内存。
  *        而静态创建的信号量在使用完毕后调用 `rt_sem_detach`。
  */
 rt_err_t semaphore_generator(rt_sem_t *sem_ptr,
@@ -51,6 +689,19 @@ rt_err_t semaphore_generator(rt_sem_t *sem_ptr,
                              rt_uint8_t flag,
                              rt_bool_t is_dynamic)
 {
+#ifdef RTREPACK_USING_STATIC_POOLS
+    // 静态池配置：动态请求改由静态池提供控制块与缓冲区，随后按静态方式初始化
+    if (is_dynamic)
+    {
+        *sem_ptr = (rt_sem_t)repack_pool_alloc(REPACK_POOL_SEM, RT_NULL, 0);
+        if (*sem_ptr == RT_NULL)
+        {
+            LOG_E("semaphore pool exhausted...\n");
+            return -ENOMEM;
+        }
+        is_dynamic = RT_FALSE;
+    }
+#else
     if (is_dynamic)
     { // 动态创建
         *sem_ptr = rt_sem_create(name, initial_value, flag);
@@ -62,6 +713,7 @@ rt_err_t semaphore_generator(rt_sem_t *sem_ptr,
         LOG_D("rt_sem_create sccessed...\n");
     }
     else
+#endif
     {
         // 静态创建
         int ret = RT_EOK;
@@ -73,6 +725,7 @@ rt_err_t semaphore_generator(rt_sem_t *sem_ptr,
         }
         LOG_D("rt_sem_init sccessed...\n");
     }
+    repack_object_created((rt_object_t)*sem_ptr, is_dynamic);
     return RT_EOK;
 }
 
@@ -90,7 +743,7 @@ rt_err_t semaphore_generator(rt_sem_t *sem_ptr,
  * @param[in]      stack_addr     线程的栈地址。动态创建时传 `RT_NULL`。静态时可定义全局：`rt_uint8_t th_stack[size] = {0};`再传入th_stack的首地址
  * @param[in]      stack_size     线程栈大小。动态创建时传入自定义大小（如1024等）。静态时可直接传入`sizeof(th_stack)`
  * @param[in]      priority       线程的优先级。
- * @param[in]      tick           线程的时间片。
+ * @param[in]      tick           线程的时间片。加入协作调度组（`coop_group_add`）期间不再按时间片轮转。
  * @param[in]      is_dynamic     指示是否动态创建线程。
  *                                - `RT_TRUE`：动态创建线程，内核将分配内存。
  *                                - `RT_FALSE`：静态创建线程，需提供有效的控制块地址和栈地址。
@@ -100,7 +753,7 @@ rt_err_t semaphore_generator(rt_sem_t *sem_ptr,
  *         - 非 `RT_EOK`：静态创建失败。
  *
  * @note  若使用动态创建线程（`is_dynamic` 为 `RT_TRUE`），
- *        用户需在线程不再使用时调用 `rt_thread_delete` 释放内存。
+ *        用户需在线程不再使用时调用 `repack_thread_delete` 释放内存。
  *        而静态创建的线程在使用完毕后无需调用销毁函数。
  */
 rt_err_t thread_generator(rt_thread_t *th_ptr,
@@ -113,6 +766,19 @@ rt_err_t thread_generator(rt_thread_t *th_ptr,
                           rt_uint8_t tick,
                           rt_bool_t is_dynamic)
 {
+#ifdef RTREPACK_USING_STATIC_POOLS
+    // 静态池配置：动态请求改由静态池提供控制块与缓冲区，随后按静态方式初始化
+    if (is_dynamic)
+    {
+        *th_ptr = (rt_thread_t)repack_pool_alloc(REPACK_POOL_THREAD, &stack_addr, stack_size);
+        if (*th_ptr == RT_NULL)
+        {
+            LOG_E("thread pool exhausted...\n");
+            return -ENOMEM;
+        }
+        is_dynamic = RT_FALSE;
+    }
+#else
     if (is_dynamic)
     { // 动态创建
         *th_ptr = rt_thread_create(name, entry, parameter, stack_size, priority, tick);
@@ -124,6 +790,7 @@ rt_err_t thread_generator(rt_thread_t *th_ptr,
         LOG_D("rt_thread_create succeeded...\n");
     }
     else
+#endif
     {
         // 静态创建
         int ret = rt_thread_init(*th_ptr, name, entry, parameter, stack_addr, stack_size, priority, tick);
@@ -134,6 +801,7 @@ rt_err_t thread_generator(rt_thread_t *th_ptr,
         }
         LOG_D("rt_thread_init succeeded...\n");
     }
+    repack_object_created((rt_object_t)*th_ptr, is_dynamic);
     return RT_EOK;
 }
 
@@ -158,8 +826,10 @@ rt_err_t thread_generator(rt_thread_t *th_ptr,
  *         - 非 `RT_EOK`：静态创建失败。
  *
  * @note  若使用动态创建互斥量（`is_dynamic` 为 `RT_TRUE`），
- *        用户需在互斥量不再使用时调用 `rt_mutex_delete` 释放内存。
+ *        用户需在互斥量不再使用时调用 `repack_mutex_delete` 释放内存。
  *        而静态创建的互斥量在使用完毕后无需调用销毁函数。
+
+ *        该互斥量采用优先级继承；控制回路等需要确定最坏延迟的场合可改用 `ceiling_mutex_generator`。
  */
 
 rt_err_t mutex_generator(rt_mutex_t *mutex_ptr,
@@ -167,6 +837,19 @@ rt_err_t mutex_generator(rt_mutex_t *mutex_ptr,
                          rt_uint8_t flag,
                          rt_bool_t is_dynamic)
 {
+#ifdef RTREPACK_USING_STATIC_POOLS
+    // 静态池配置：动态请求改由静态池提供控制块与缓冲区，随后按静态方式初始化
+    if (is_dynamic)
+    {
+        *mutex_ptr = (rt_mutex_t)repack_pool_alloc(REPACK_POOL_MUTEX, RT_NULL, 0);
+        if (*mutex_ptr == RT_NULL)
+        {
+            LOG_E("mutex pool exhausted...\n");
+            return -ENOMEM;
+        }
+        is_dynamic = RT_FALSE;
+    }
+#else
     if (is_dynamic)
     {
         *mutex_ptr = rt_mutex_create(name, flag);
@@ -178,6 +861,7 @@ rt_err_t mutex_generator(rt_mutex_t *mutex_ptr,
         LOG_D("rt_mutex_create succeeded...\n");
     }
     else
+#endif
     {
         int ret = RT_EOK;
         ret = rt_mutex_init(*mutex_ptr, name, flag);
@@ -188,22 +872,317 @@ rt_err_t mutex_generator(rt_mutex_t *mutex_ptr,
         }
         LOG_D("rt_mutex_init succeeded...\n");
     }
+    repack_object_created((rt_object_t)*mutex_ptr, is_dynamic);
     return RT_EOK;
 }
 
 /**
- * @brief  创建或初始化一个事件集，支持动态和静态创建。
+ * 立即优先级天花板互斥量：加锁时先把持有者提升到天花板优先级再获取，
+ * 解锁后恢复原优先级。只要天花板不低于所有使用者的优先级，单核上加锁就不会阻塞，
+ * 也不会发生优先级继承的链式提升，最坏延迟只取决于最长临界区。
+ * 底层用一个按优先级排队的二值信号量，SMP 上多核同时争用时才会阻塞。
+ */
+struct ceiling_mutex
+{
+    struct rt_semaphore sem;
+    rt_thread_t owner;
+    rt_uint8_t ceiling;
+    rt_uint8_t saved_priority;   /* 持有者加锁前的优先级 */
+    rt_bool_t is_dynamic;
+};
+typedef struct ceiling_mutex *ceiling_mutex_t;
+
+/**
+ * @brief  创建或初始化一个优先级天花板互斥量，支持动态和静态创建。
  *
- * @param[in,out]  event_ptr      指向要创建或初始化的事件集控制块的指针。
- *                                - 若 `is_dynamic` 为 `RT_FALSE`（静态创建），
- *                                  则需传入已分配的事件集控制块的地址。可定义全局：`struct rt_event event;`
- *                                - 若 `is_dynamic` 为 `RT_TRUE`（动态创建），
- *                                  则传入一个值 `RT_NULL` 的指针，内核将动态分配内存。可定义全局：`rt_event_t event = RT_NULL;`
- * @param[in]      name           事件集的名称字符串。
- * @param[in]      flag           事件集的创建标志位，定义事件集的行为特性：
- *                                - `RT_IPC_FLAG_FIFO`：先进先出方式
- *                                - `RT_IPC_FLAG_PRIO`：优先级方式
- * @param[in]      is_dynamic     指示是否动态创建事件集。
+ * @param[in,out]  cm_ptr      指向互斥量控制块的指针。
+ *                             - 若 `is_dynamic` 为 `RT_FALSE`（静态创建），
+ *                               则需传入已分配的控制块地址。可定义全局：`struct ceiling_mutex lock;`
+ *                             - 若 `is_dynamic` 为 `RT_TRUE`（动态创建），
+ *                               则传入一个值 `RT_NULL` 的指针即可。可定义全局：`ceiling_mutex_t lock = RT_NULL;`
+ * @param[in]      name        互斥量的名称字符串。
+ * @param[in]      ceiling     天花板优先级，取所有会加这把锁的线程中最高的优先级（数值最小）。
+ * @param[in]      is_dynamic  指示是否动态创建。
+ *
+ * @return `RT_EOK` 表示成功，其他错误代码表示失败：
+ *         - `-ENOMEM`：内存不足导致动态创建失败。
+ *         - 非 `RT_EOK`：静态创建失败。
+ *
+ * @note  动态创建的互斥量不再使用时调用 `ceiling_mutex_delete`，静态创建的调用 `ceiling_mutex_detach`。
+ *        不支持递归加锁；嵌套持有多把天花板互斥量时须按加锁的相反顺序解锁。
+ */
+rt_err_t ceiling_mutex_generator(ceiling_mutex_t *cm_ptr,
+                                 const char *name,
+                                 rt_uint8_t ceiling,
+                                 rt_bool_t is_dynamic)
+{
+    int ret = RT_EOK;
+
+    RT_ASSERT(ceiling < RT_THREAD_PRIORITY_MAX);
+    if (is_dynamic)
+    {
+        *cm_ptr = (ceiling_mutex_t)repack_malloc(sizeof(struct ceiling_mutex));
+        if (*cm_ptr == RT_NULL)
+        {
+            LOG_E("ceiling_mutex malloc failed...\n");
+            return -ENOMEM;
+        }
+    }
+    ret = rt_sem_init(&(*cm_ptr)->sem, name, 1, RT_IPC_FLAG_PRIO);
+    if (ret != RT_EOK)
+    {
+        LOG_E("ceiling_mutex rt_sem_init failed...\n");
+        if (is_dynamic)
+        {
+            repack_free(*cm_ptr);
+            *cm_ptr = RT_NULL;
+        }
+        return ret;
+    }
+    (*cm_ptr)->owner = RT_NULL;
+    (*cm_ptr)->ceiling = ceiling;
+    (*cm_ptr)->saved_priority = ceiling;
+    (*cm_ptr)->is_dynamic = is_dynamic;
+    LOG_D("ceiling_mutex init succeeded...\n");
+    repack_object_created(&(*cm_ptr)->sem.parent.parent, RT_FALSE);
+    if (is_dynamic)
+        repack_heap_tag(*cm_ptr, sizeof(struct ceiling_mutex), REPACK_HEAP_CEILING_MUTEX, name);
+    return RT_EOK;
+}
+
+/**
+ * @brief 脱离静态创建的优先级天花板互斥量。
+ */
+rt_err_t ceiling_mutex_detach(ceiling_mutex_t cm)
+{
+    RT_ASSERT(cm != RT_NULL && cm->is_dynamic == RT_FALSE);
+    return rt_sem_detach(&cm->sem);
+}
+
+/**
+ * @brief 删除动态创建的优先级天花板互斥量并释放内存。
+ */
+rt_err_t ceiling_mutex_delete(ceiling_mutex_t cm)
+{
+    RT_ASSERT(cm != RT_NULL && cm->is_dynamic == RT_TRUE);
+    rt_sem_detach(&cm->sem);
+    repack_heap_untag(cm);
+    repack_free(cm);
+    return RT_EOK;
+}
+
+/**
+ * @brief 加锁：先把当前线程提升到天花板优先级，再获取锁。只能在线程中调用。
+ *
+ * @param[in] timeout  多核争用时的等待时间，单核且天花板设置正确时不会等待。
+ *
+ * @return `RT_EOK` 表示成功，超时返回 `-RT_ETIMEOUT`，此时优先级已恢复。
+ */
+rt_err_t ceiling_mutex_take(ceiling_mutex_t cm, rt_int32_t timeout)
+{
+    rt_thread_t thread = rt_thread_self();
+    rt_uint8_t priority = repack_thread_cur_priority(thread);
+    rt_err_t ret;
+
+    // 基础优先级高于天花板说明天花板配置有误；当前优先级可能已被嵌套持有的
+    // 其他天花板锁或优先级继承抬高，不能据此断言
+    RT_ASSERT(repack_thread_init_priority(thread) >= cm->ceiling);
+    RT_ASSERT(cm->owner != thread);
+    if (priority > cm->ceiling)
+        rt_thread_control(thread, RT_THREAD_CTRL_CHANGE_PRIORITY, &cm->ceiling);
+
+    ret = rt_sem_take(&cm->sem, timeout);
+    if (ret != RT_EOK)
+    {
+        if (priority > cm->ceiling)
+            rt_thread_control(thread, RT_THREAD_CTRL_CHANGE_PRIORITY, &priority);
+        return ret;
+    }
+    cm->owner = thread;
+    cm->saved_priority = priority;
+    return RT_EOK;
+}
+
+/**
+ * @brief 解锁并恢复加锁前的优先级，只能由持有者调用。
+ */
+rt_err_t ceiling_mutex_release(ceiling_mutex_t cm)
+{
+    rt_thread_t thread = rt_thread_self();
+    rt_uint8_t priority = cm->saved_priority;
+
+    RT_ASSERT(cm->owner == thread);
+    cm->owner = RT_NULL;
+    rt_sem_release(&cm->sem);
+    // 释放时仍处于天花板优先级，被唤醒的等待者在恢复优先级之后才可能抢占；
+    // 加锁时未抬高优先级（已处于更高优先级）则保持不变
+    if (priority > cm->ceiling && priority != repack_thread_cur_priority(thread))
+        rt_thread_control(thread, RT_THREAD_CTRL_CHANGE_PRIORITY, &priority);
+    return RT_EOK;
+}
+
+/**
+ * 轻量互斥量：非递归，只在调试构建（RT_DEBUG / RT_USING_DEBUG）中检查持有者。
+ * 状态字 0 为空闲、1 为已加锁、2 为已加锁且可能有等待者。无竞争时加锁与解锁
+ * 各只有一次原子操作；只有争用时才通过内部信号量进入内核阻塞。
+ * 没有优先级继承，适合临界区短、使用者优先级相近的热路径。
+ */
+#if defined(RT_DEBUG) || defined(RT_USING_DEBUG)
+#define LITE_MUTEX_CHECK_OWNER
+#endif
+
+struct lite_mutex
+{
+    volatile rt_uint32_t state;
+    struct rt_semaphore sem;    /* 争用时的等待队列 */
+#ifdef LITE_MUTEX_CHECK_OWNER
+    rt_thread_t owner;
+#endif
+    rt_bool_t is_dynamic;
+};
+typedef struct lite_mutex *lite_mutex_t;
+
+/**
+ * @brief  创建或初始化一个轻量互斥量，支持动态和静态创建。
+ *
+ * @param[in,out]  lm_ptr      指向互斥量控制块的指针。
+ *                             - 若 `is_dynamic` 为 `RT_FALSE`（静态创建），
+ *                               则需传入已分配的控制块地址。可定义全局：`struct lite_mutex lock;`
+ *                             - 若 `is_dynamic` 为 `RT_TRUE`（动态创建），
+ *                               则传入一个值 `RT_NULL` 的指针即可。可定义全局：`lite_mutex_t lock = RT_NULL;`
+ * @param[in]      name        互斥量的名称字符串。
+ * @param[in]      is_dynamic  指示是否动态创建。
+ *
+ * @return `RT_EOK` 表示成功，其他错误代码表示失败：
+ *         - `-ENOMEM`：内存不足导致动态创建失败。
+ *         - 非 `RT_EOK`：静态创建失败。
+ *
+ * @note  动态创建的互斥量不再使用时调用 `lite_mutex_delete`，静态创建的调用 `lite_mutex_detach`。
+ */
+rt_err_t lite_mutex_generator(lite_mutex_t *lm_ptr,
+                              const char *name,
+                              rt_bool_t is_dynamic)
+{
+    int ret = RT_EOK;
+
+    if (is_dynamic)
+    {
+        *lm_ptr = (lite_mutex_t)repack_malloc(sizeof(struct lite_mutex));
+        if (*lm_ptr == RT_NULL)
+        {
+            LOG_E("lite_mutex malloc failed...\n");
+            return -ENOMEM;
+        }
+    }
+    ret = rt_sem_init(&(*lm_ptr)->sem, name, 0, RT_IPC_FLAG_PRIO);
+    if (ret != RT_EOK)
+    {
+        LOG_E("lite_mutex rt_sem_init failed...\n");
+        if (is_dynamic)
+        {
+            repack_free(*lm_ptr);
+            *lm_ptr = RT_NULL;
+        }
+        return ret;
+    }
+    (*lm_ptr)->state = 0;
+#ifdef LITE_MUTEX_CHECK_OWNER
+    (*lm_ptr)->owner = RT_NULL;
+#endif
+    (*lm_ptr)->is_dynamic = is_dynamic;
+    LOG_D("lite_mutex init succeeded...\n");
+    repack_object_created(&(*lm_ptr)->sem.parent.parent, RT_FALSE);
+    if (is_dynamic)
+        repack_heap_tag(*lm_ptr, sizeof(struct lite_mutex), REPACK_HEAP_LITE_MUTEX, name);
+    return RT_EOK;
+}
+
+/**
+ * @brief 脱离静态创建的轻量互斥量。
+ */
+rt_err_t lite_mutex_detach(lite_mutex_t lm)
+{
+    RT_ASSERT(lm != RT_NULL && lm->is_dynamic == RT_FALSE);
+    return rt_sem_detach(&lm->sem);
+}
+
+/**
+ * @brief 删除动态创建的轻量互斥量并释放内存。
+ */
+rt_err_t lite_mutex_delete(lite_mutex_t lm)
+{
+    RT_ASSERT(lm != RT_NULL && lm->is_dynamic == RT_TRUE);
+    rt_sem_detach(&lm->sem);
+    repack_heap_untag(lm);
+    repack_free(lm);
+    return RT_EOK;
+}
+
+/* 争用路径：把状态置为 2 后阻塞，被唤醒后重试，直到从空闲状态抢到锁 */
+static rt_err_t lite_mutex_take_slow(lite_mutex_t lm, rt_int32_t timeout)
+{
+    rt_err_t ret;
+
+    while (repack_atomic_xchg(&lm->state, 2) != 0)
+    {
+        if (timeout == 0)
+            return -RT_ETIMEOUT;
+        ret = rt_sem_take(&lm->sem, timeout);
+        if (ret != RT_EOK)
+            return ret;
+    }
+    return RT_EOK;
+}
+
+/**
+ * @brief 加锁，只能在线程中调用，不可递归。
+ *
+ * @param[in] timeout  争用时的等待时间，每次被唤醒后重新计时。
+ *
+ * @return `RT_EOK` 表示成功，超时返回 `-RT_ETIMEOUT`。
+ */
+rt_inline rt_err_t lite_mutex_take(lite_mutex_t lm, rt_int32_t timeout)
+{
+    rt_err_t ret = RT_EOK;
+
+#ifdef LITE_MUTEX_CHECK_OWNER
+    RT_ASSERT(lm->owner != rt_thread_self());
+#endif
+    if (!repack_atomic_cas(&lm->state, 0, 1))
+        ret = lite_mutex_take_slow(lm, timeout);
+#ifdef LITE_MUTEX_CHECK_OWNER
+    if (ret == RT_EOK)
+        lm->owner = rt_thread_self();
+#endif
+    return ret;
+}
+
+/**
+ * @brief 解锁，只能由持有者调用。状态为 2 时唤醒一个等待者。
+ */
+rt_inline void lite_mutex_release(lite_mutex_t lm)
+{
+#ifdef LITE_MUTEX_CHECK_OWNER
+    RT_ASSERT(lm->owner == rt_thread_self());
+    lm->owner = RT_NULL;
+#endif
+    if (repack_atomic_xchg(&lm->state, 0) == 2)
+        rt_sem_release(&lm->sem);
+}
+
+/**
+ * @brief  创建或初始化一个事件集，支持动态和静态创建。
+ *
+ * @param[in,out]  event_ptr      指向要创建或初始化的事件集控制块的指针。
+ *                                - 若 `is_dynamic` 为 `RT_FALSE`（静态创建），
+ *                                  则需传入已分配的事件集控制块的地址。可定义全局：`struct rt_event event;`
+ *                                - 若 `is_dynamic` 为 `RT_TRUE`（动态创建），
+ *                                  则传入一个值 `RT_NULL` 的指针，内核将动态分配内存。可定义全局：`rt_event_t event = RT_NULL;`
+ * @param[in]      name           事件集的名称字符串。
+ * @param[in]      flag           事件集的创建标志位，定义事件集的行为特性：
+ *                                - `RT_IPC_FLAG_FIFO`：先进先出方式
+ *                                - `RT_IPC_FLAG_PRIO`：优先级方式
+ * @param[in]      is_dynamic     指示是否动态创建事件集。
  *                                - `RT_TRUE`：动态创建事件集，内核将分配内存。
  *                                - `RT_FALSE`：静态创建事件集，需提供有效的控制块地址。
  *
@@ -212,7 +1191,7 @@ rt_err_t mutex_generator(rt_mutex_t *mutex_ptr,
  *         - 非 `RT_EOK`：静态创建失败。
  *
  * @note  若使用动态创建事件集（`is_dynamic` 为 `RT_TRUE`），
- *        用户需在事件集不再使用时调用 `rt_event_delete` 释放内存。
+ *        用户需在事件集不再使用时调用 `repack_event_delete` 释放内存。
  *        而静态创建的事件集在使用完毕后无需调用销毁函数。
  */
 
@@ -221,6 +1200,19 @@ rt_err_t event_generator(rt_event_t *event_ptr,
                          rt_uint8_t flag,
                          rt_bool_t is_dynamic)
 {
+#ifdef RTREPACK_USING_STATIC_POOLS
+    // 静态池配置：动态请求改由静态池提供控制块与缓冲区，随后按静态方式初始化
+    if (is_dynamic)
+    {
+        *event_ptr = (rt_event_t)repack_pool_alloc(REPACK_POOL_EVENT, RT_NULL, 0);
+        if (*event_ptr == RT_NULL)
+        {
+            LOG_E("event pool exhausted...\n");
+            return -ENOMEM;
+        }
+        is_dynamic = RT_FALSE;
+    }
+#else
     if (is_dynamic)
     {
         *event_ptr = rt_event_create(name, flag);
@@ -232,6 +1224,7 @@ rt_err_t event_generator(rt_event_t *event_ptr,
         LOG_D("rt_event_create succeeded...\n");
     }
     else
+#endif
     {
         int ret = RT_EOK;
         ret = rt_event_init(*event_ptr, name, flag);
@@ -242,6 +1235,7 @@ rt_err_t event_generator(rt_event_t *event_ptr,
         }
         LOG_D("rt_event_init succeeded...\n");
     }
+    repack_object_created((rt_object_t)*event_ptr, is_dynamic);
     return RT_EOK;
 }
 
@@ -266,7 +1260,7 @@ rt_err_t event_generator(rt_event_t *event_ptr,
  *         - 非 `RT_EOK`：静态创建失败。
  *
  * @note 若使用动态创建邮箱（`is_dynamic` 为 `RT_TRUE`），
- *       用户需在邮箱不再使用时调用 `rt_mb_delete` 释放内存。
+ *       用户需在邮箱不再使用时调用 `repack_mb_delete` 释放内存。
  *       而静态创建的邮箱在使用完毕后无需调用销毁函数。
  */
 rt_err_t mailbox_generator(rt_mailbox_t *mb_ptr,
@@ -276,6 +1270,19 @@ rt_err_t mailbox_generator(rt_mailbox_t *mb_ptr,
                            rt_uint8_t flag,
                            rt_bool_t is_dynamic)
 {
+#ifdef RTREPACK_USING_STATIC_POOLS
+    // 静态池配置：动态请求改由静态池提供控制块与缓冲区，随后按静态方式初始化
+    if (is_dynamic)
+    {
+        *mb_ptr = (rt_mailbox_t)repack_pool_alloc(REPACK_POOL_MAILBOX, &msgpool, size * sizeof(rt_ubase_t));
+        if (*mb_ptr == RT_NULL)
+        {
+            LOG_E("mailbox pool exhausted...\n");
+            return -ENOMEM;
+        }
+        is_dynamic = RT_FALSE;
+    }
+#else
     if (is_dynamic)
     {
         // 动态创建邮箱
@@ -288,6 +1295,7 @@ rt_err_t mailbox_generator(rt_mailbox_t *mb_ptr,
         LOG_D("rt_mb_create succeeded...\n");
     }
     else
+#endif
     {
         // 静态初始化邮箱
         int ret = RT_EOK;
@@ -299,6 +1307,7 @@ rt_err_t mailbox_generator(rt_mailbox_t *mb_ptr,
         }
         LOG_D("rt_mb_init succeeded...\n");
     }
+    repack_object_created((rt_object_t)*mb_ptr, is_dynamic);
     return RT_EOK;
 }
 
@@ -324,7 +1333,7 @@ rt_err_t mailbox_generator(rt_mailbox_t *mb_ptr,
  *         - 非 `RT_EOK`：静态创建失败。
  *
  * @note 若使用动态创建邮件队列（`is_dynamic` 为 `RT_TRUE`），
- *       用户需在邮件队列不再使用时调用 `rt_mq_delete` 释放内存。
+ *       用户需在邮件队列不再使用时调用 `repack_mq_delete` 释放内存。
  *       而静态创建的邮件队列在使用完毕后无需调用销毁函数。
  */
 rt_err_t messagequeue_generator(rt_mq_t *mq_ptr,
@@ -335,6 +1344,24 @@ rt_err_t messagequeue_generator(rt_mq_t *mq_ptr,
                                 rt_uint8_t flag,
                                 rt_bool_t is_dynamic)
 {
+#ifdef RTREPACK_USING_STATIC_POOLS
+    rt_size_t max_msgs = 0;
+
+    // 静态池配置：动态请求改由静态池提供控制块与缓冲区，随后按静态方式初始化
+    if (is_dynamic)
+    {
+        /* 动态路径中 pool_size 交给 rt_mq_create 即消息条数，这里换算成消息池字节数以保持容量不变 */
+        max_msgs = pool_size;
+        pool_size = pool_size * (RT_ALIGN(msg_size, RT_ALIGN_SIZE) + REPACK_MQ_MSG_HDR_SIZE);
+        *mq_ptr = (rt_mq_t)repack_pool_alloc(REPACK_POOL_MQ, &msgpool, pool_size);
+        if (*mq_ptr == RT_NULL)
+        {
+            LOG_E("messagequeue pool exhausted...\n");
+            return -ENOMEM;
+        }
+        is_dynamic = RT_FALSE;
+    }
+#else
     if (is_dynamic)
     {
         // 动态创建
@@ -347,6 +1374,7 @@ rt_err_t messagequeue_generator(rt_mq_t *mq_ptr,
         LOG_D("rt_mq_create succeeded...\n");
     }
     else
+#endif
     {
         // 静态初始化
         int ret = RT_EOK;
@@ -356,9 +1384,5602 @@ rt_err_t messagequeue_generator(rt_mq_t *mq_ptr,
             LOG_E("rt_mq_init failed...\n");
             return ret;
         }
+#ifdef RTREPACK_USING_STATIC_POOLS
+        // 容量不符说明 REPACK_MQ_MSG_HDR_SIZE 与内核消息头大小不一致
+        if (max_msgs != 0 && (*mq_ptr)->max_msgs != max_msgs)
+        {
+            LOG_E("messagequeue header size mismatch...\n");
+            rt_mq_detach(*mq_ptr);
+            return -RT_EINVAL;
+        }
+#endif
         LOG_D("rt_mq_init succeeded...\n");
     }
+    repack_object_created((rt_object_t)*mq_ptr, is_dynamic);
+    return RT_EOK;
+}
+
+/**
+ * 协作调度组：同一优先级的一组线程之间不再按时间片轮转，只在显式让出点
+ * （`coop_yield` 或阻塞）切换，避免吞吐型线程在操作中途互相打断造成缓存与锁的反复争抢。
+ * 组内线程仍可被更高优先级的线程抢占，抢占返回后继续运行原线程。
+ *
+ * 实现方式是把组内线程的时间片设为 `COOP_SLICE_TICKS`，节拍中断几乎不会耗尽它；
+ * 离开组时恢复原时间片。与组外同优先级线程之间同样不再轮转，因此同一优先级上
+ * 最好只放协作组成员。
+ * 开启 RT_USING_HOOK 时成员线程退出（对象脱离）后自动移出组，否则线程退出前须先调用
+ * `coop_group_remove`。组在有成员期间须一直有效，不再使用时调用 `coop_group_detach`。
+ */
+#ifndef COOP_GROUP_MAX
+#define COOP_GROUP_MAX 8
+#endif
+#define COOP_SLICE_TICKS ((rt_ubase_t)0x7FFFFFFF)
+
+struct coop_group
+{
+    struct coop_group *next;                 /* 已初始化的组，供线程退出时查找 */
+    rt_uint8_t priority;
+    rt_uint8_t count;
+    rt_thread_t threads[COOP_GROUP_MAX];
+    rt_ubase_t saved_tick[COOP_GROUP_MAX];   /* 加入前的时间片，离开时恢复 */
+};
+typedef struct coop_group *coop_group_t;
+
+/* 组链表与各组成员表，静态清零即为未上锁 */
+static coop_group_t coop_groups;
+static repack_lock_t coop_lock;
+
+/* 在调度器锁内替换线程的时间片，返回原时间片 */
+static rt_ubase_t coop_swap_slice(rt_thread_t thread, rt_ubase_t tick)
+{
+    repack_sched_level_t level;
+    rt_ubase_t old;
+
+    repack_sched_lock(level);
+    old = repack_thread_init_tick(thread);
+    repack_thread_init_tick(thread) = tick;
+    repack_thread_remaining_tick(thread) = tick;
+    repack_sched_unlock(level);
+    return old;
+}
+
+/* 从组中移出线程并恢复其时间片，调用方已持有 coop_lock */
+static rt_bool_t coop_group_take(coop_group_t group, rt_thread_t thread)
+{
+    rt_uint8_t i;
+
+    for (i = 0; i < group->count; i++)
+    {
+        if (group->threads[i] != thread)
+            continue;
+        coop_swap_slice(thread, group->saved_tick[i]);
+        group->count--;
+        group->threads[i] = group->threads[group->count];
+        group->saved_tick[i] = group->saved_tick[group->count];
+        return RT_TRUE;
+    }
+    return RT_FALSE;
+}
+
+/**
+ * @brief 初始化协作调度组。
+ *
+ * @param[in] priority  组内线程的优先级，加入的线程必须处于该优先级。
+ */
+void coop_group_init(coop_group_t group, rt_uint8_t priority)
+{
+    rt_base_t level;
+
+    rt_memset(group, 0, sizeof(*group));
+    group->priority = priority;
+#ifdef RT_USING_HOOK
+    repack_detach_hook_install();
+#endif
+    level = repack_lock(&coop_lock);
+    group->next = coop_groups;
+    coop_groups = group;
+    repack_unlock(&coop_lock, level);
+}
+
+/**
+ * @brief 解散协作调度组：全部成员恢复原时间片，组不再被引用。
+ */
+void coop_group_detach(coop_group_t group)
+{
+    coop_group_t *link;
+    rt_base_t level;
+
+    level = repack_lock(&coop_lock);
+    while (group->count > 0)
+        coop_group_take(group, group->threads[group->count - 1]);
+    for (link = &coop_groups; *link != RT_NULL; link = &(*link)->next)
+    {
+        if (*link == group)
+        {
+            *link = group->next;
+            break;
+        }
+    }
+    repack_unlock(&coop_lock, level);
+}
+
+/**
+ * @brief 把线程加入协作调度组，此后该线程不再因时间片耗尽而被同优先级线程切换。
+ *
+ * @return `RT_EOK` 表示成功；`-RT_EINVAL` 表示优先级不符；`-RT_EFULL` 表示组已满。
+ */
+rt_err_t coop_group_add(coop_group_t group, rt_thread_t thread)
+{
+    rt_base_t level;
+
+    if (repack_thread_init_priority(thread) != group->priority)
+    {
+        LOG_E("coop_group: %.*s priority mismatch...\n", RT_NAME_MAX, thread->name);
+        return -RT_EINVAL;
+    }
+    level = repack_lock(&coop_lock);
+    if (group->count >= COOP_GROUP_MAX)
+    {
+        repack_unlock(&coop_lock, level);
+        return -RT_EFULL;
+    }
+    group->threads[group->count] = thread;
+    group->saved_tick[group->count] = coop_swap_slice(thread, COOP_SLICE_TICKS);
+    group->count++;
+    repack_unlock(&coop_lock, level);
+    return RT_EOK;
+}
+
+/**
+ * @brief 把线程移出协作调度组并恢复原时间片。
+ *
+ * @return `RT_EOK` 表示成功，`-RT_ERROR` 表示线程不在组内。
+ */
+rt_err_t coop_group_remove(coop_group_t group, rt_thread_t thread)
+{
+    rt_bool_t found;
+    rt_base_t level;
+
+    level = repack_lock(&coop_lock);
+    found = coop_group_take(group, thread);
+    repack_unlock(&coop_lock, level);
+    return found ? RT_EOK : -RT_ERROR;
+}
+
+/* 线程脱离时从所有组中移出，由对象脱离钩子调用 */
+static void coop_thread_detached(rt_thread_t thread)
+{
+    coop_group_t group;
+    rt_base_t level;
+
+    level = repack_lock(&coop_lock);
+    for (group = coop_groups; group != RT_NULL; group = group->next)
+        coop_group_take(group, thread);
+    repack_unlock(&coop_lock, level);
+}
+
+/**
+ * @brief 协作让出点：把 CPU 交给同优先级的下一个就绪线程，没有其他就绪线程时立即返回。
+ *        组内线程应在每完成一个工作单元后调用。
+ */
+rt_inline void coop_yield(void)
+{
+    rt_thread_yield();
+}
+
+/*
+ * 非破坏性观测：深度查询与就地窥视，不出队也不重新入队，供诊断线程高频采样。
+ * 深度查询只读一个计数字段，不关中断；窥视与快照只在拷贝期间短暂关中断，
+ * 关中断的时长与拷贝的字节数成正比，快照的条数由调用方的缓冲区限定。
+ */
+
+/**
+ * @brief 邮箱中当前的邮件数。
+ */
+rt_inline rt_uint16_t mailbox_depth(rt_mailbox_t mb)
+{
+    return mb->entry;
+}
+
+/**
+ * @brief 消息队列中当前的消息数。
+ */
+rt_inline rt_uint16_t mq_depth(rt_mq_t mq)
+{
+    return mq->entry;
+}
+
+/*
+ * 遍历邮箱/消息队列内部时与内核 IPC 互斥。5.x 的 SMP 内核用对象自带的自旋锁保护这些字段，
+ * 关中断只屏蔽本核，必须拿同一把锁；单核或 4.x 内核仍以关中断为准。
+ */
+#if defined(RT_USING_SMP) && defined(RT_VERSION_MAJOR) && (RT_VERSION_MAJOR >= 5)
+#define repack_ipc_lock(obj)           rt_spin_lock_irqsave(&(obj)->spinlock)
+#define repack_ipc_unlock(obj, level)  rt_spin_unlock_irqrestore(&(obj)->spinlock, level)
+#else
+#define repack_ipc_lock(obj)           ((void)(obj), rt_hw_interrupt_disable())
+#define repack_ipc_unlock(obj, level)  ((void)(obj), rt_hw_interrupt_enable(level))
+#endif
+
+/**
+ * @brief 读取邮箱中第 index 封邮件（0 为队首，即下一次接收将取到的邮件），不出队。
+ *
+ * @return `RT_EOK` 表示成功，`-RT_EEMPTY` 表示邮件数不足 index + 1。
+ */
+rt_err_t mailbox_peek(rt_mailbox_t mb, rt_uint16_t index, rt_ubase_t *value)
+{
+    rt_base_t level = repack_ipc_lock(mb);
+
+    if (index >= mb->entry)
+    {
+        repack_ipc_unlock(mb, level);
+        return -RT_EEMPTY;
+    }
+    *value = mb->msg_pool[(mb->out_offset + index) % mb->size];
+    repack_ipc_unlock(mb, level);
     return RT_EOK;
 }
 
+/**
+ * @brief 按从队首到队尾的顺序拷贝邮箱中的邮件，不出队。
+ *
+ * @param[out] values  接收邮件的数组。
+ * @param[in]  max     数组容量，最多拷贝这么多封。
+ *
+ * @return 拷贝的邮件数。
+ */
+rt_uint16_t mailbox_snapshot(rt_mailbox_t mb, rt_ubase_t *values, rt_uint16_t max)
+{
+    rt_base_t level = repack_ipc_lock(mb);
+    rt_uint16_t i, n = (mb->entry < max) ? mb->entry : max;
+    rt_uint16_t offset = mb->out_offset;
+
+    for (i = 0; i < n; i++)
+    {
+        values[i] = mb->msg_pool[offset];
+        if (++offset >= mb->size)
+            offset = 0;
+    }
+    repack_ipc_unlock(mb, level);
+    return n;
+}
+
+/* 消息体长度：5.x 的消息头记录了实际发送长度，4.x 只能按消息槽大小计 */
+rt_inline rt_size_t mq_message_length(rt_mq_t mq, const struct repack_mq_message *msg)
+{
+#if defined(RT_VERSION_MAJOR) && (RT_VERSION_MAJOR >= 5)
+    (void)mq;
+    return (rt_size_t)msg->length;
+#else
+    (void)msg;
+    return mq->msg_size;
+#endif
+}
+
+/**
+ * @brief 拷贝消息队列中第 index 条消息（0 为队首）的消息体，不出队。
+ *
+ * @param[out] buffer  接收消息体的缓冲区。
+ * @param[in]  size    缓冲区大小，超出部分被截断。
+ *
+ * @return 拷贝的字节数；消息数不足 index + 1 时返回 `-RT_EEMPTY`。
+ *
+ * @note  定位第 index 条消息需要沿链表走 index 步，高频采样时宜只看队首或使用 `mq_snapshot`。
+ */
+rt_int32_t mq_peek(rt_mq_t mq, rt_uint16_t index, void *buffer, rt_size_t size)
+{
+    struct repack_mq_message *msg;
+    rt_base_t level;
+    rt_size_t length;
+
+    level = repack_ipc_lock(mq);
+    if (index >= mq->entry)
+    {
+        repack_ipc_unlock(mq, level);
+        return -RT_EEMPTY;
+    }
+    msg = (struct repack_mq_message *)mq->msg_queue_head;
+    while (index--)
+        msg = msg->next;
+    length = mq_message_length(mq, msg);
+    if (length > size)
+        length = size;
+    rt_memcpy(buffer, (rt_uint8_t *)msg + REPACK_MQ_MSG_HDR_SIZE, length);
+    repack_ipc_unlock(mq, level);
+    return (rt_int32_t)length;
+}
+
+/**
+ * @brief 按从队首到队尾的顺序拷贝消息队列中的消息体，不出队。
+ *
+ * @param[out] buffer   接收消息体的缓冲区，第 i 条消息拷贝到 buffer + i * stride。
+ * @param[in]  stride   每条消息在缓冲区中占用的字节数，超出部分被截断。
+ * @param[in]  max      最多拷贝的消息条数。
+ * @param[out] lengths  可选，每条消息的长度（截断前），不需要时传 `RT_NULL`。
+ *
+ * @return 拷贝的消息条数。
+ */
+rt_uint16_t mq_snapshot(rt_mq_t mq, void *buffer, rt_size_t stride, rt_uint16_t max, rt_size_t *lengths)
+{
+    struct repack_mq_message *msg;
+    rt_base_t level;
+    rt_uint16_t i, n;
+
+    level = repack_ipc_lock(mq);
+    n = (mq->entry < max) ? mq->entry : max;
+    msg = (struct repack_mq_message *)mq->msg_queue_head;
+    for (i = 0; i < n; i++, msg = msg->next)
+    {
+        rt_size_t length = mq_message_length(mq, msg);
+
+        if (lengths != RT_NULL)
+            lengths[i] = length;
+        rt_memcpy((rt_uint8_t *)buffer + i * stride, (rt_uint8_t *)msg + REPACK_MQ_MSG_HDR_SIZE,
+                  (length < stride) ? length : stride);
+    }
+    repack_ipc_unlock(mq, level);
+    return n;
+}
+
+/**
+ * 按核分片的统计计数器：每个核一个独占缓存行的槽位，每个槽位放一组（SHARDED_COUNTER_WIDTH 个）计数，
+ * 计数时只对本核槽位做一次宽松原子加，读取时把各核槽位相加。
+ * 计数在多核上不再争用同一缓存行，读取较慢且只保证最终一致，适合发送/接收/超时这类统计。
+ */
+#ifndef SHARDED_COUNTER_WIDTH
+#define SHARDED_COUNTER_WIDTH 4
+#endif
+
+struct sharded_counter_slot
+{
+    volatile rt_uint32_t value[SHARDED_COUNTER_WIDTH];
+} ALIGN(RTREPACK_CACHE_LINE);
+
+struct sharded_counter
+{
+    struct sharded_counter_slot slots[RTREPACK_CPUS_NR];
+};
+typedef struct sharded_counter *sharded_counter_t;
+
+/**
+ * @brief 清零整组计数。
+ */
+rt_inline void sharded_counter_reset(sharded_counter_t counter)
+{
+    rt_memset(counter, 0, sizeof(*counter));
+}
+
+/**
+ * @brief 第 index 个计数加 n，可在任意线程或中断中调用。
+ */
+rt_inline void sharded_counter_add(sharded_counter_t counter, rt_uint8_t index, rt_uint32_t n)
+{
+    repack_atomic_add_relaxed(&counter->slots[repack_cpu_id()].value[index], n);
+}
+
+/**
+ * @brief 第 index 个计数加 1。
+ */
+rt_inline void sharded_counter_inc(sharded_counter_t counter, rt_uint8_t index)
+{
+    sharded_counter_add(counter, index, 1);
+}
+
+/**
+ * @brief 读取第 index 个计数（各核之和）。
+ */
+rt_inline rt_uint32_t sharded_counter_read(sharded_counter_t counter, rt_uint8_t index)
+{
+    rt_uint32_t sum = 0;
+    rt_uint8_t i;
+
+    for (i = 0; i < RTREPACK_CPUS_NR; i++)
+        sum += counter->slots[i].value[index];
+    return sum;
+}
+
+/**
+ * 按核分片的消息队列：每个核一个子队列，各占独立的缓存行。
+ * 生产者投递到本核子队列，消费者先取本核子队列，为空时才依次从其他核“窃取”，
+ * 多核共用一个队列时队首/队尾所在缓存行在核间来回迁移的问题由此消除。
+ * 阻塞等待通过一个事件集完成：只有登记了等待者时生产者才发送事件，无人等待时不触碰共享数据。
+ * 各子队列之间不保证先后顺序，同一核上投递的消息保持先进先出。
+ */
+#define SHARDED_MQ_EVENT_ITEM   (1 << 0)    /* 有新消息 */
+#define SHARDED_MQ_EVENT_SPACE  (1 << 1)    /* 有空位 */
+
+/* 统计计数编号，用 `sharded_mq_stat` 读取 */
+#define SHARDED_MQ_STAT_SEND     0   /* 发送成功 */
+#define SHARDED_MQ_STAT_RECV     1   /* 接收成功 */
+#define SHARDED_MQ_STAT_STEAL    2   /* 从其他核分片取得或投到其他核分片 */
+#define SHARDED_MQ_STAT_TIMEOUT  3   /* 发送或接收失败（满、空或超时） */
+
+struct sharded_mq_shard
+{
+    struct rt_messagequeue mq;
+} ALIGN(RTREPACK_CACHE_LINE);
+
+struct sharded_mq
+{
+    struct sharded_mq_shard shards[RTREPACK_CPUS_NR];
+    struct rt_event event;
+    volatile rt_uint32_t recv_waiters;
+    volatile rt_uint32_t send_waiters;
+    struct sharded_counter stats;
+    void *mem;          /* 动态创建时分配的原始地址 */
+    rt_bool_t is_dynamic;
+};
+typedef struct sharded_mq *sharded_mq_t;
+
+/* 静态创建时 `msgpool` 所需的字节数（全部分片） */
+#define SHARDED_MQ_POOL_SIZE(msg_size, max_msgs) \
+    (RTREPACK_CPUS_NR * (max_msgs) * (RT_ALIGN((msg_size), RT_ALIGN_SIZE) + REPACK_MQ_MSG_HDR_SIZE))
+
+/**
+ * @brief 创建或初始化一个分片消息队列，支持动态和静态创建。
+ *
+ * @param[in,out] smq_ptr     指向分片消息队列控制块的指针。
+ *                            - 若 `is_dynamic` 为 `RT_FALSE`（静态创建），
+ *                              则需传入已分配的控制块地址。可定义全局：`struct sharded_mq smq;`
+ *                            - 若 `is_dynamic` 为 `RT_TRUE`（动态创建），
+ *                              则传入一个值 `RT_NULL` 的指针，控制块与消息池一次性动态分配。可定义全局：`sharded_mq_t smq = RT_NULL;`
+ * @param[in]     name        队列名称（各分片共用）。
+ * @param[in]     msgpool     静态创建时由用户分配 `SHARDED_MQ_POOL_SIZE(msg_size, max_msgs)` 字节；动态创建时传入 `RT_NULL`。
+ * @param[in]     msg_size    单条消息的最大长度。
+ * @param[in]     max_msgs    每个分片的容量（消息条数）。
+ * @param[in]     is_dynamic  指示是否动态创建。
+ *
+ * @return `RT_EOK` 表示成功，其他错误代码表示失败：
+ *         - `-ENOMEM`：内存不足导致动态创建失败。
+ *         - 非 `RT_EOK`：静态创建失败。
+ *
+ * @note 动态创建的队列不再使用时调用 `sharded_mq_delete`，静态创建的调用 `sharded_mq_detach`。
+ */
+rt_err_t sharded_mq_generator(sharded_mq_t *smq_ptr,
+                              const char *name,
+                              void *msgpool,
+                              rt_size_t msg_size,
+                              rt_size_t max_msgs,
+                              rt_bool_t is_dynamic)
+{
+    rt_size_t shard_bytes = max_msgs * (RT_ALIGN(msg_size, RT_ALIGN_SIZE) + REPACK_MQ_MSG_HDR_SIZE);
+    rt_size_t bytes = 0;
+    void *mem = RT_NULL;
+    rt_uint8_t i;
+    int ret = RT_EOK;
+
+    if (is_dynamic)
+    {
+        rt_size_t head = RT_ALIGN(sizeof(struct sharded_mq), RT_ALIGN_SIZE);
+
+        // 多分配一个缓存行，使各分片按缓存行对齐
+        bytes = RTREPACK_CACHE_LINE + head + SHARDED_MQ_POOL_SIZE(msg_size, max_msgs);
+        mem = repack_malloc(bytes);
+        if (mem == RT_NULL)
+        {
+            LOG_E("sharded_mq malloc failed...\n");
+            return -ENOMEM;
+        }
+        *smq_ptr = (sharded_mq_t)RT_ALIGN((rt_ubase_t)mem, RTREPACK_CACHE_LINE);
+        msgpool = (rt_uint8_t *)(*smq_ptr) + head;
+    }
+
+    for (i = 0; i < RTREPACK_CPUS_NR; i++)
+    {
+        ret = rt_mq_init(&(*smq_ptr)->shards[i].mq, name, (rt_uint8_t *)msgpool + i * shard_bytes, msg_size,
+                         shard_bytes, RT_IPC_FLAG_FIFO);
+        if (ret != RT_EOK)
+        {
+            LOG_E("sharded_mq rt_mq_init failed...\n");
+            goto __fail;
+        }
+        // 容量不符说明 REPACK_MQ_MSG_HDR_SIZE 与内核消息头大小不一致
+        if ((*smq_ptr)->shards[i].mq.max_msgs != max_msgs)
+        {
+            LOG_E("sharded_mq header size mismatch...\n");
+            i++;
+            ret = -RT_EINVAL;
+            goto __fail;
+        }
+    }
+    ret = rt_event_init(&(*smq_ptr)->event, name, RT_IPC_FLAG_PRIO);
+    if (ret != RT_EOK)
+    {
+        LOG_E("sharded_mq rt_event_init failed...\n");
+        goto __fail;
+    }
+    (*smq_ptr)->recv_waiters = 0;
+    (*smq_ptr)->send_waiters = 0;
+    sharded_counter_reset(&(*smq_ptr)->stats);
+    (*smq_ptr)->mem = mem;
+    (*smq_ptr)->is_dynamic = is_dynamic;
+    for (i = 0; i < RTREPACK_CPUS_NR; i++)
+        repack_object_created(&(*smq_ptr)->shards[i].mq.parent.parent, RT_FALSE);
+    if (is_dynamic)
+        repack_heap_tag(mem, bytes, REPACK_HEAP_SHARDED_MQ, name);
+    LOG_D("sharded_mq init succeeded...\n");
+    return RT_EOK;
+
+__fail:
+    while (i-- > 0)
+        rt_mq_detach(&(*smq_ptr)->shards[i].mq);
+    if (is_dynamic)
+    {
+        repack_free(mem);
+        *smq_ptr = RT_NULL;
+    }
+    return ret;
+}
+
+static void sharded_mq_release(sharded_mq_t smq)
+{
+    rt_uint8_t i;
+
+    for (i = 0; i < RTREPACK_CPUS_NR; i++)
+        rt_mq_detach(&smq->shards[i].mq);
+    rt_event_detach(&smq->event);
+}
+
+/**
+ * @brief 脱离静态创建的分片消息队列。
+ */
+rt_err_t sharded_mq_detach(sharded_mq_t smq)
+{
+    RT_ASSERT(smq != RT_NULL && smq->is_dynamic == RT_FALSE);
+    sharded_mq_release(smq);
+    return RT_EOK;
+}
+
+/**
+ * @brief 删除动态创建的分片消息队列并释放内存。
+ */
+rt_err_t sharded_mq_delete(sharded_mq_t smq)
+{
+    RT_ASSERT(smq != RT_NULL && smq->is_dynamic == RT_TRUE);
+    sharded_mq_release(smq);
+    repack_heap_untag(smq->mem);
+    repack_free(smq->mem);
+    return RT_EOK;
+}
+
+/*
+ * 在有等待者时发送事件，无等待者时只读一次计数。
+ * 分片本身由内核加锁，跨核竞争只在等待者计数上：等待方先登记再检查分片，通知方先写分片再读计数，
+ * 两边都是“写后读”，SMP 下须用全屏障隔开，否则两核可能同时看到旧值而丢失唤醒。
+ */
+rt_inline void sharded_mq_notify(sharded_mq_t smq, volatile rt_uint32_t *waiters, rt_uint32_t set)
+{
+    repack_atomic_fence();
+    if (repack_atomic_load(waiters) != 0)
+        rt_event_send(&smq->event, set);
+}
+
+/*
+ * 阻塞等待 set：先登记等待者再重试一次 attempt，避免在检查之后、等待之前到来的通知丢失。
+ * 返回 attempt 的结果，超时返回 -RT_ETIMEOUT。
+ */
+static rt_err_t sharded_mq_wait(sharded_mq_t smq, volatile rt_uint32_t *waiters, rt_uint32_t set,
+                                rt_err_t (*attempt)(sharded_mq_t, void *, rt_size_t), void *buffer,
+                                rt_size_t size, rt_int32_t timeout)
+{
+    rt_tick_t deadline = rt_tick_get() + (rt_tick_t)timeout;
+    rt_uint32_t recved;
+    rt_err_t ret;
+
+    for (;;)
+    {
+        rt_int32_t remain = RT_WAITING_FOREVER;
+
+        repack_atomic_add(waiters, 1);
+        ret = attempt(smq, buffer, size);
+        if (ret == RT_EOK)
+        {
+            repack_atomic_add(waiters, (rt_uint32_t)-1);
+            return RT_EOK;
+        }
+        if (timeout != RT_WAITING_FOREVER)
+        {
+            remain = (rt_int32_t)(deadline - rt_tick_get());
+            if (remain <= 0)
+            {
+                repack_atomic_add(waiters, (rt_uint32_t)-1);
+                return -RT_ETIMEOUT;
+            }
+        }
+        ret = rt_event_recv(&smq->event, set, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, remain, &recved);
+        repack_atomic_add(waiters, (rt_uint32_t)-1);
+        if (ret != RT_EOK)
+            return ret;
+    }
+}
+
+/* 非阻塞投递：本核分片优先，满了再投到其他分片 */
+static rt_err_t sharded_mq_try_send(sharded_mq_t smq, void *buffer, rt_size_t size)
+{
+    rt_uint8_t cpu = repack_cpu_id();
+    rt_uint8_t i;
+
+    for (i = 0; i < RTREPACK_CPUS_NR; i++)
+    {
+        if (rt_mq_send(&smq->shards[(cpu + i) % RTREPACK_CPUS_NR].mq, buffer, size) == RT_EOK)
+        {
+            sharded_counter_inc(&smq->stats, SHARDED_MQ_STAT_SEND);
+            if (i != 0)
+                sharded_counter_inc(&smq->stats, SHARDED_MQ_STAT_STEAL);
+            sharded_mq_notify(smq, &smq->recv_waiters, SHARDED_MQ_EVENT_ITEM);
+            return RT_EOK;
+        }
+    }
+    return -RT_EFULL;
+}
+
+/* 非阻塞接收：本核分片优先，空了再从其他分片窃取 */
+static rt_err_t sharded_mq_try_recv(sharded_mq_t smq, void *buffer, rt_size_t size)
+{
+    rt_uint8_t cpu = repack_cpu_id();
+    rt_uint8_t i;
+
+    for (i = 0; i < RTREPACK_CPUS_NR; i++)
+    {
+        struct rt_messagequeue *mq = &smq->shards[(cpu + i) % RTREPACK_CPUS_NR].mq;
+
+        if (mq->entry == 0)
+            continue;
+        if ((rt_int32_t)rt_mq_recv(mq, buffer, size, RT_WAITING_NO) >= 0)
+        {
+            sharded_counter_inc(&smq->stats, SHARDED_MQ_STAT_RECV);
+            if (i != 0)
+                sharded_counter_inc(&smq->stats, SHARDED_MQ_STAT_STEAL);
+            sharded_mq_notify(smq, &smq->send_waiters, SHARDED_MQ_EVENT_SPACE);
+            return RT_EOK;
+        }
+    }
+    return -RT_EEMPTY;
+}
+
+/**
+ * @brief 发送消息，所有分片都满时按 timeout 等待空位。参数与 `rt_mq_send_wait` 相同，
+ *        `timeout` 为 `RT_WAITING_NO` 时可在中断中调用。
+ */
+rt_err_t sharded_mq_send_wait(sharded_mq_t smq, const void *buffer, rt_size_t size, rt_int32_t timeout)
+{
+    rt_err_t ret;
+
+    if (sharded_mq_try_send(smq, (void *)buffer, size) == RT_EOK)
+        return RT_EOK;
+    ret = (timeout == 0) ? -RT_EFULL
+                         : sharded_mq_wait(smq, &smq->send_waiters, SHARDED_MQ_EVENT_SPACE, sharded_mq_try_send,
+                                           (void *)buffer, size, timeout);
+    if (ret != RT_EOK)
+        sharded_counter_inc(&smq->stats, SHARDED_MQ_STAT_TIMEOUT);
+    return ret;
+}
+
+/**
+ * @brief 非阻塞发送，可在中断中调用。
+ */
+rt_inline rt_err_t sharded_mq_send(sharded_mq_t smq, const void *buffer, rt_size_t size)
+{
+    return sharded_mq_send_wait(smq, buffer, size, RT_WAITING_NO);
+}
+
+/**
+ * @brief 接收消息，所有分片都为空时按 timeout 等待。
+ *
+ * @return `RT_EOK` 表示成功，`-RT_ETIMEOUT` 表示超时（`timeout` 为 0 时为 `-RT_EEMPTY`）。
+ *
+ * @note 与 `rt_mq_recv` 不同，成功时不返回消息长度，消息按 `msg_size` 拷贝。
+ */
+rt_err_t sharded_mq_recv(sharded_mq_t smq, void *buffer, rt_size_t size, rt_int32_t timeout)
+{
+    rt_err_t ret;
+
+    if (sharded_mq_try_recv(smq, buffer, size) == RT_EOK)
+        return RT_EOK;
+    ret = (timeout == 0) ? -RT_EEMPTY
+                         : sharded_mq_wait(smq, &smq->recv_waiters, SHARDED_MQ_EVENT_ITEM, sharded_mq_try_recv,
+                                           buffer, size, timeout);
+    if (ret != RT_EOK)
+        sharded_counter_inc(&smq->stats, SHARDED_MQ_STAT_TIMEOUT);
+    return ret;
+}
+
+/**
+ * @brief 全部分片中的消息总数。
+ */
+rt_inline rt_uint32_t sharded_mq_depth(sharded_mq_t smq)
+{
+    rt_uint32_t depth = 0;
+    rt_uint8_t i;
+
+    for (i = 0; i < RTREPACK_CPUS_NR; i++)
+        depth += smq->shards[i].mq.entry;
+    return depth;
+}
+
+/**
+ * @brief 读取统计计数，`index` 为 `SHARDED_MQ_STAT_xxx`。
+ */
+rt_inline rt_uint32_t sharded_mq_stat(sharded_mq_t smq, rt_uint8_t index)
+{
+    return sharded_counter_read(&smq->stats, index);
+}
+
+/**
+ * 提交/完成环：应用线程与驱动线程之间按 io_uring 的方式交换请求。
+ * 应用把一批请求写入提交环（SQ），驱动一次取走一批处理，再把结果成批写入完成环（CQ），
+ * 应用成批收割。唤醒按批进行：驱动只在即将睡眠时置 `IO_RING_SQ_NEED_WAKEUP`，
+ * 提交方看到该标志才发送事件；应用只在登记了等待时才被唤醒。
+ * 开启轮询模式后驱动在提交环为空时先轮询一段时间再睡眠，请求密集时提交方完全不需要唤醒驱动。
+ *
+ * 提交与收割可由多个应用线程（包括其他核上的线程）进行，各自在短暂的临界区内拷贝；
+ * 取请求与写完成只能由一个驱动线程进行。完成环容量应不小于同时在途的请求数。
+ */
+#define IO_RING_SQ_NEED_WAKEUP  (1 << 0)    /* 驱动已睡眠或即将睡眠，提交后需唤醒 */
+
+#define IO_RING_EVENT_SQ        (1 << 0)
+#define IO_RING_EVENT_CQ        (1 << 1)
+
+/* 提交项，opcode 与各字段的含义由驱动约定 */
+struct io_ring_sqe
+{
+    rt_uint8_t opcode;
+    rt_uint8_t flags;
+    rt_uint16_t ioprio;
+    rt_uint32_t len;
+    rt_uint32_t offset;
+    void *buf;
+    rt_ubase_t user_data;   /* 原样带回完成项，用于对应请求 */
+};
+
+/* 完成项 */
+struct io_ring_cqe
+{
+    rt_ubase_t user_data;
+    rt_int32_t result;      /* 非负为结果（如传输字节数），负值为错误码 */
+    rt_uint32_t flags;
+};
+
+struct io_ring
+{
+    volatile rt_uint32_t sq_head;   /* 驱动写 */
+    volatile rt_uint32_t sq_tail;   /* 提交方写 */
+    volatile rt_uint32_t cq_head;   /* 收割方写 */
+    volatile rt_uint32_t cq_tail;   /* 驱动写 */
+    volatile rt_uint32_t sq_flags;
+    volatile rt_uint32_t cq_waiters;
+    rt_uint32_t sq_mask;
+    rt_uint32_t cq_mask;
+    rt_int32_t poll_idle;           /* 轮询模式下空转多少 tick 后睡眠，0 为不轮询 */
+    repack_lock_t sq_lock;          /* 提交方之间互斥 */
+    repack_lock_t cq_lock;          /* 收割方之间互斥 */
+    struct io_ring_sqe *sqes;
+    struct io_ring_cqe *cqes;
+    struct rt_event event;
+    rt_bool_t is_dynamic;
+};
+typedef struct io_ring *io_ring_t;
+
+/* 静态创建时 `pool` 所需的字节数 */
+#define IO_RING_POOL_SIZE(sq_entries, cq_entries) \
+    ((sq_entries) * sizeof(struct io_ring_sqe) + (cq_entries) * sizeof(struct io_ring_cqe))
+
+/**
+ * @brief 创建或初始化一对提交/完成环，支持动态和静态创建。
+ *
+ * @param[in,out] ring_ptr    指向环控制块的指针。
+ *                            - 若 `is_dynamic` 为 `RT_FALSE`（静态创建），
+ *                              则需传入已分配的控制块地址。可定义全局：`struct io_ring ring;`
+ *                            - 若 `is_dynamic` 为 `RT_TRUE`（动态创建），
+ *                              则传入一个值 `RT_NULL` 的指针，控制块与两个环一次性动态分配。可定义全局：`io_ring_t ring = RT_NULL;`
+ * @param[in]     name        名称（内部事件集使用）。
+ * @param[in]     pool        静态创建时由用户分配 `IO_RING_POOL_SIZE(sq_entries, cq_entries)` 字节并按指针大小对齐；
+ *                            动态创建时传入 `RT_NULL`。
+ * @param[in]     sq_entries  提交环容量，须为 2 的幂。
+ * @param[in]     cq_entries  完成环容量，须为 2 的幂，一般取提交环的 2 倍。
+ * @param[in]     is_dynamic  指示是否动态创建。
+ *
+ * @return `RT_EOK` 表示成功，其他错误代码表示失败：
+ *         - `-ENOMEM`：内存不足导致动态创建失败。
+ *         - `-RT_EINVAL`：容量不是 2 的幂。
+ *         - 非 `RT_EOK`：静态创建失败。
+ *
+ * @note 动态创建的环不再使用时调用 `io_ring_delete`，静态创建的调用 `io_ring_detach`。
+ */
+rt_err_t io_ring_generator(io_ring_t *ring_ptr,
+                           const char *name,
+                           void *pool,
+                           rt_uint32_t sq_entries,
+                           rt_uint32_t cq_entries,
+                           rt_bool_t is_dynamic)
+{
+    rt_size_t bytes = 0;
+    int ret = RT_EOK;
+
+    if (sq_entries == 0 || (sq_entries & (sq_entries - 1)) != 0 ||
+        cq_entries == 0 || (cq_entries & (cq_entries - 1)) != 0)
+    {
+        LOG_E("io_ring entries must be a power of two...\n");
+        return -RT_EINVAL;
+    }
+    if (is_dynamic)
+    {
+        rt_size_t head = RT_ALIGN(sizeof(struct io_ring), RT_ALIGN_SIZE);
+
+        bytes = head + IO_RING_POOL_SIZE(sq_entries, cq_entries);
+        *ring_ptr = (io_ring_t)repack_malloc(bytes);
+        if (*ring_ptr == RT_NULL)
+        {
+            LOG_E("io_ring malloc failed...\n");
+            return -ENOMEM;
+        }
+        pool = (rt_uint8_t *)(*ring_ptr) + head;
+    }
+
+    ret = rt_event_init(&(*ring_ptr)->event, name, RT_IPC_FLAG_PRIO);
+    if (ret != RT_EOK)
+    {
+        LOG_E("io_ring rt_event_init failed...\n");
+        if (is_dynamic)
+        {
+            repack_free(*ring_ptr);
+            *ring_ptr = RT_NULL;
+        }
+        return ret;
+    }
+    (*ring_ptr)->sq_head = (*ring_ptr)->sq_tail = 0;
+    (*ring_ptr)->cq_head = (*ring_ptr)->cq_tail = 0;
+    (*ring_ptr)->sq_flags = 0;
+    (*ring_ptr)->cq_waiters = 0;
+    (*ring_ptr)->sq_mask = sq_entries - 1;
+    (*ring_ptr)->cq_mask = cq_entries - 1;
+    (*ring_ptr)->poll_idle = 0;
+    repack_lock_init(&(*ring_ptr)->sq_lock);
+    repack_lock_init(&(*ring_ptr)->cq_lock);
+    (*ring_ptr)->sqes = (struct io_ring_sqe *)pool;
+    (*ring_ptr)->cqes = (struct io_ring_cqe *)((*ring_ptr)->sqes + sq_entries);
+    (*ring_ptr)->is_dynamic = is_dynamic;
+    LOG_D("io_ring init succeeded...\n");
+    repack_object_created(&(*ring_ptr)->event.parent.parent, RT_FALSE);
+    if (is_dynamic)
+        repack_heap_tag(*ring_ptr, bytes, REPACK_HEAP_IO_RING, name);
+    return RT_EOK;
+}
+
+/**
+ * @brief 脱离静态创建的提交/完成环。
+ */
+rt_err_t io_ring_detach(io_ring_t ring)
+{
+    RT_ASSERT(ring != RT_NULL && ring->is_dynamic == RT_FALSE);
+    return rt_event_detach(&ring->event);
+}
+
+/**
+ * @brief 删除动态创建的提交/完成环并释放内存。
+ */
+rt_err_t io_ring_delete(io_ring_t ring)
+{
+    RT_ASSERT(ring != RT_NULL && ring->is_dynamic == RT_TRUE);
+    rt_event_detach(&ring->event);
+    repack_heap_untag(ring);
+    repack_free(ring);
+    return RT_EOK;
+}
+
+/**
+ * @brief 设置驱动侧的轮询模式。
+ *
+ * @param[in] idle_ticks  提交环为空时驱动先轮询多少 tick 再睡眠，0 为关闭轮询（立即睡眠）。
+ *                        轮询期间驱动线程反复让出 CPU，只占用同优先级及更低优先级线程的时间。
+ */
+rt_inline void io_ring_set_poll(io_ring_t ring, rt_int32_t idle_ticks)
+{
+    ring->poll_idle = idle_ticks;
+}
+
+/**
+ * @brief 批量提交请求（应用侧）。
+ *
+ * @return 实际提交的条数，提交环空位不足时只提交前面的部分。
+ */
+rt_uint32_t io_ring_submit(io_ring_t ring, const struct io_ring_sqe *sqes, rt_uint32_t count)
+{
+    rt_base_t level;
+    rt_uint32_t tail, space, i;
+
+    level = repack_lock(&ring->sq_lock);
+    tail = ring->sq_tail;
+    space = ring->sq_mask + 1 - (tail - repack_atomic_load(&ring->sq_head));
+    if (count > space)
+        count = space;
+    for (i = 0; i < count; i++)
+        ring->sqes[(tail + i) & ring->sq_mask] = sqes[i];
+    repack_atomic_store(&ring->sq_tail, tail + count);
+    repack_unlock(&ring->sq_lock, level);
+
+    // 与驱动置位 NEED_WAKEUP 后再检查提交环的顺序配对，保证不会漏掉唤醒
+    repack_atomic_fence();
+    if (count != 0 && (ring->sq_flags & IO_RING_SQ_NEED_WAKEUP) &&
+        (repack_atomic_xchg(&ring->sq_flags, 0) & IO_RING_SQ_NEED_WAKEUP))
+        rt_event_send(&ring->event, IO_RING_EVENT_SQ);
+    return count;
+}
+
+/* 从提交环拷出最多 max 条 */
+static rt_uint32_t io_ring_take_sqes(io_ring_t ring, struct io_ring_sqe *sqes, rt_uint32_t max)
+{
+    rt_uint32_t head = ring->sq_head;
+    rt_uint32_t n = repack_atomic_load(&ring->sq_tail) - head;
+    rt_uint32_t i;
+
+    if (n > max)
+        n = max;
+    for (i = 0; i < n; i++)
+        sqes[i] = ring->sqes[(head + i) & ring->sq_mask];
+    repack_atomic_store(&ring->sq_head, head + n);
+    return n;
+}
+
+/**
+ * @brief 批量取出待处理的请求（驱动侧，仅一个驱动线程调用）。
+ *
+ * 提交环为空时，轮询模式下先轮询 `poll_idle` 个 tick，然后置 `IO_RING_SQ_NEED_WAKEUP` 并睡眠，
+ * 直到有新的提交或超时。
+ *
+ * @param[in] timeout  睡眠的最长时间，`RT_WAITING_NO` 为不等待。
+ *
+ * @return 取出的条数，超时为 0。
+ */
+rt_uint32_t io_ring_fetch(io_ring_t ring, struct io_ring_sqe *sqes, rt_uint32_t max, rt_int32_t timeout)
+{
+    rt_tick_t poll_start = rt_tick_get();
+    rt_uint32_t n, recved;
+
+    for (;;)
+    {
+        n = io_ring_take_sqes(ring, sqes, max);
+        if (n != 0 || timeout == 0)
+            return n;
+        if (ring->poll_idle > 0 && (rt_int32_t)(rt_tick_get() - poll_start) < ring->poll_idle)
+        {
+            rt_thread_yield();
+            continue;
+        }
+
+        repack_atomic_xchg(&ring->sq_flags, IO_RING_SQ_NEED_WAKEUP);
+        repack_atomic_fence();
+        n = io_ring_take_sqes(ring, sqes, max);
+        if (n != 0)
+        {
+            repack_atomic_xchg(&ring->sq_flags, 0);
+            return n;
+        }
+        if (rt_event_recv(&ring->event, IO_RING_EVENT_SQ, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, timeout,
+                          &recved) != RT_EOK)
+        {
+            repack_atomic_xchg(&ring->sq_flags, 0);
+            return io_ring_take_sqes(ring, sqes, max);
+        }
+        poll_start = rt_tick_get();
+    }
+}
+
+/**
+ * @brief 批量写入完成项（驱动侧，仅一个驱动线程调用），有应用在等待时唤醒一次。
+ *
+ * @return 实际写入的条数，完成环空位不足时只写入前面的部分，其余应稍后重试。
+ */
+rt_uint32_t io_ring_complete(io_ring_t ring, const struct io_ring_cqe *cqes, rt_uint32_t count)
+{
+    rt_uint32_t tail = ring->cq_tail;
+    rt_uint32_t space = ring->cq_mask + 1 - (tail - repack_atomic_load(&ring->cq_head));
+    rt_uint32_t i;
+
+    if (count > space)
+        count = space;
+    for (i = 0; i < count; i++)
+        ring->cqes[(tail + i) & ring->cq_mask] = cqes[i];
+    repack_atomic_store(&ring->cq_tail, tail + count);
+
+    repack_atomic_fence();
+    if (count != 0 && repack_atomic_load(&ring->cq_waiters) != 0)
+        rt_event_send(&ring->event, IO_RING_EVENT_CQ);
+    return count;
+}
+
+/* 从完成环拷出最多 max 条，多个收割者之间互斥 */
+static rt_uint32_t io_ring_take_cqes(io_ring_t ring, struct io_ring_cqe *cqes, rt_uint32_t max)
+{
+    rt_base_t level = repack_lock(&ring->cq_lock);
+    rt_uint32_t head = ring->cq_head;
+    rt_uint32_t n = repack_atomic_load(&ring->cq_tail) - head;
+    rt_uint32_t i;
+
+    if (n > max)
+        n = max;
+    for (i = 0; i < n; i++)
+        cqes[i] = ring->cqes[(head + i) & ring->cq_mask];
+    repack_atomic_store(&ring->cq_head, head + n);
+    repack_unlock(&ring->cq_lock, level);
+    return n;
+}
+
+/**
+ * @brief 批量收割完成项（应用侧）。
+ *
+ * @param[in] max          最多收割的条数。
+ * @param[in] min_complete 至少等到这么多条才返回（超时除外），0 为只收割已有的。
+ * @param[in] timeout      等待的最长时间。
+ *
+ * @return 收割的条数。
+ */
+rt_uint32_t io_ring_reap(io_ring_t ring, struct io_ring_cqe *cqes, rt_uint32_t max,
+                         rt_uint32_t min_complete, rt_int32_t timeout)
+{
+    rt_tick_t deadline = rt_tick_get() + (rt_tick_t)timeout;
+    rt_uint32_t n = io_ring_take_cqes(ring, cqes, max);
+    rt_uint32_t recved;
+
+    if (min_complete > max)
+        min_complete = max;
+    while (n < min_complete && timeout != 0)
+    {
+        rt_int32_t remain = RT_WAITING_FOREVER;
+        rt_err_t ret;
+
+        if (timeout != RT_WAITING_FOREVER)
+        {
+            remain = (rt_int32_t)(deadline - rt_tick_get());
+            if (remain <= 0)
+                break;
+        }
+        repack_atomic_add(&ring->cq_waiters, 1);
+        repack_atomic_fence();
+        n += io_ring_take_cqes(ring, cqes + n, max - n);
+        if (n >= min_complete)
+        {
+            repack_atomic_add(&ring->cq_waiters, (rt_uint32_t)-1);
+            break;
+        }
+        ret = rt_event_recv(&ring->event, IO_RING_EVENT_CQ, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, remain,
+                            &recved);
+        repack_atomic_add(&ring->cq_waiters, (rt_uint32_t)-1);
+        n += io_ring_take_cqes(ring, cqes + n, max - n);
+        if (ret != RT_EOK)
+            break;
+    }
+    return n;
+}
+
+/**
+ * DMA 缓冲池：固定大小、按指定对齐（默认缓存行）的缓冲区，可放在指定的内存区域
+ * （静态创建时由用户提供该区域内的内存，动态创建时从指定的 memheap 分配）。
+ * 缓冲区以指针的形式经邮箱或消息队列（`struct dma_buf_desc`）传递，消费者直接交给 DMA，
+ * 不经过中转拷贝。每个缓冲区占整数个对齐单元，缓存维护不会波及相邻缓冲区。
+ * 空闲缓冲区的首个字存放空闲链表指针，池本身不额外占用该区域的内存。
+ */
+#ifndef DMA_POOL_ALIGN
+#define DMA_POOL_ALIGN RTREPACK_CACHE_LINE
+#endif
+
+struct dma_pool
+{
+    struct rt_semaphore free_sem;   /* 空闲缓冲区计数，用于阻塞申请 */
+    void *free_list;
+    repack_lock_t lock;             /* 保护空闲链表，申请与归还可能在不同的核上 */
+    rt_uint8_t *base;
+    rt_size_t stride;
+    rt_size_t align;
+    rt_uint16_t count;
+    void *mem;                      /* 动态创建时分配的原始地址 */
+    struct rt_memheap *heap;
+    rt_bool_t is_dynamic;
+};
+typedef struct dma_pool *dma_pool_t;
+
+/* 经邮箱/消息队列按引用传递的缓冲区描述 */
+struct dma_buf_desc
+{
+    void *buf;
+    rt_uint32_t len;        /* 有效数据长度 */
+    rt_ubase_t user_data;
+};
+
+/* 静态创建时 `region` 所需的字节数（含对齐余量） */
+#define DMA_POOL_SIZE(buf_size, buf_count, align) ((buf_count) * RT_ALIGN((buf_size), (align)) + (align))
+
+/**
+ * @brief 创建或初始化一个 DMA 缓冲池，支持动态和静态创建。
+ *
+ * @param[in,out] dp_ptr      指向缓冲池控制块的指针。
+ *                            - 若 `is_dynamic` 为 `RT_FALSE`（静态创建），
+ *                              则需传入已分配的控制块地址。可定义全局：`struct dma_pool pool;`
+ *                            - 若 `is_dynamic` 为 `RT_TRUE`（动态创建），
+ *                              则传入一个值 `RT_NULL` 的指针即可。可定义全局：`dma_pool_t pool = RT_NULL;`
+ * @param[in]     name        名称。
+ * @param[in]     region      静态创建时缓冲区所在的内存，至少 `DMA_POOL_SIZE(buf_size, buf_count, align)` 字节，
+ *                            可用 `RT_SECTION` 放到 DMA 可访问的区域；动态创建时传入 `RT_NULL`。
+ * @param[in]     heap        动态创建时缓冲区来自的 memheap（需 RT_USING_MEMHEAP），`RT_NULL` 为系统堆；静态创建时忽略。
+ * @param[in]     buf_size    单个缓冲区的大小。
+ * @param[in]     buf_count   缓冲区个数。
+ * @param[in]     align       对齐字节数（2 的幂，不小于指针大小），0 为 `DMA_POOL_ALIGN`。
+ * @param[in]     is_dynamic  指示是否动态创建。
+ *
+ * @return `RT_EOK` 表示成功，其他错误代码表示失败：
+ *         - `-ENOMEM`：内存不足导致动态创建失败。
+ *         - 非 `RT_EOK`：静态创建失败。
+ *
+ * @note 动态创建的缓冲池不再使用时调用 `dma_pool_delete`，静态创建的调用 `dma_pool_detach`。
+ */
+rt_err_t dma_pool_generator(dma_pool_t *dp_ptr,
+                            const char *name,
+                            void *region,
+                            struct rt_memheap *heap,
+                            rt_size_t buf_size,
+                            rt_uint16_t buf_count,
+                            rt_size_t align,
+                            rt_bool_t is_dynamic)
+{
+    rt_size_t region_size;
+    rt_uint16_t i;
+    int ret = RT_EOK;
+
+    if (align == 0)
+        align = DMA_POOL_ALIGN;
+    RT_ASSERT((align & (align - 1)) == 0 && align >= sizeof(void *));
+    region_size = DMA_POOL_SIZE(buf_size, buf_count, align);
+
+    if (is_dynamic)
+    {
+        *dp_ptr = (dma_pool_t)repack_malloc(sizeof(struct dma_pool));
+        if (*dp_ptr == RT_NULL)
+        {
+            LOG_E("dma_pool malloc failed...\n");
+            return -ENOMEM;
+        }
+#ifdef RT_USING_MEMHEAP
+        region = (heap != RT_NULL) ? rt_memheap_alloc(heap, region_size) : repack_malloc(region_size);
+#else
+        RT_ASSERT(heap == RT_NULL);
+        region = repack_malloc(region_size);
+#endif
+        if (region == RT_NULL)
+        {
+            LOG_E("dma_pool buffer malloc failed...\n");
+            repack_free(*dp_ptr);
+            *dp_ptr = RT_NULL;
+            return -ENOMEM;
+        }
+    }
+
+    ret = rt_sem_init(&(*dp_ptr)->free_sem, name, buf_count, RT_IPC_FLAG_FIFO);
+    if (ret != RT_EOK)
+    {
+        LOG_E("dma_pool rt_sem_init failed...\n");
+        if (is_dynamic)
+        {
+#ifdef RT_USING_MEMHEAP
+            if (heap != RT_NULL)
+                rt_memheap_free(region);
+            else
+#endif
+                repack_free(region);
+            repack_free(*dp_ptr);
+            *dp_ptr = RT_NULL;
+        }
+        return ret;
+    }
+    (*dp_ptr)->mem = region;
+    (*dp_ptr)->heap = heap;
+    (*dp_ptr)->base = (rt_uint8_t *)RT_ALIGN((rt_ubase_t)region, align);
+    (*dp_ptr)->stride = RT_ALIGN(buf_size, align);
+    (*dp_ptr)->align = align;
+    (*dp_ptr)->count = buf_count;
+    (*dp_ptr)->is_dynamic = is_dynamic;
+    (*dp_ptr)->free_list = RT_NULL;
+    repack_lock_init(&(*dp_ptr)->lock);
+    for (i = buf_count; i > 0; i--)
+    {
+        void *buf = (*dp_ptr)->base + (i - 1) * (*dp_ptr)->stride;
+
+        *(void **)buf = (*dp_ptr)->free_list;
+        (*dp_ptr)->free_list = buf;
+    }
+    LOG_D("dma_pool init succeeded...\n");
+    repack_object_created(&(*dp_ptr)->free_sem.parent.parent, RT_FALSE);
+    // 从 memheap 取得的缓冲区不占系统堆，只计控制块
+    if (is_dynamic)
+        repack_heap_tag(*dp_ptr, sizeof(struct dma_pool) + ((heap == RT_NULL) ? region_size : 0),
+                        REPACK_HEAP_DMA_POOL, name);
+    return RT_EOK;
+}
+
+/**
+ * @brief 脱离静态创建的 DMA 缓冲池。
+ */
+rt_err_t dma_pool_detach(dma_pool_t dp)
+{
+    RT_ASSERT(dp != RT_NULL && dp->is_dynamic == RT_FALSE);
+    return rt_sem_detach(&dp->free_sem);
+}
+
+/**
+ * @brief 删除动态创建的 DMA 缓冲池并释放内存，调用前应归还全部缓冲区。
+ */
+rt_err_t dma_pool_delete(dma_pool_t dp)
+{
+    RT_ASSERT(dp != RT_NULL && dp->is_dynamic == RT_TRUE);
+    rt_sem_detach(&dp->free_sem);
+    repack_heap_untag(dp);
+#ifdef RT_USING_MEMHEAP
+    if (dp->heap != RT_NULL)
+        rt_memheap_free(dp->mem);
+    else
+#endif
+        repack_free(dp->mem);
+    repack_free(dp);
+    return RT_EOK;
+}
+
+/**
+ * @brief 申请一个缓冲区，`timeout` 为 `RT_WAITING_NO` 时可在中断中调用。
+ *
+ * @return 按池的对齐要求对齐的缓冲区，超时返回 `RT_NULL`。
+ */
+void *dma_pool_alloc(dma_pool_t dp, rt_int32_t timeout)
+{
+    rt_base_t level;
+    void *buf;
+
+    if (rt_sem_take(&dp->free_sem, timeout) != RT_EOK)
+        return RT_NULL;
+    level = repack_lock(&dp->lock);
+    buf = dp->free_list;
+    dp->free_list = *(void **)buf;
+    repack_unlock(&dp->lock, level);
+    return buf;
+}
+
+/**
+ * @brief 归还缓冲区，可在任意线程或中断（如 DMA 完成中断）中调用。
+ */
+void dma_pool_free(dma_pool_t dp, void *buf)
+{
+    rt_base_t level;
+
+    RT_ASSERT((rt_uint8_t *)buf >= dp->base && (rt_uint8_t *)buf < dp->base + dp->count * dp->stride &&
+              ((rt_uint8_t *)buf - dp->base) % dp->stride == 0);
+    level = repack_lock(&dp->lock);
+    *(void **)buf = dp->free_list;
+    dp->free_list = buf;
+    repack_unlock(&dp->lock, level);
+    rt_sem_release(&dp->free_sem);
+}
+
+/**
+ * @brief 当前空闲的缓冲区个数。
+ */
+rt_inline rt_uint16_t dma_pool_free_count(dma_pool_t dp)
+{
+    return (rt_uint16_t)dp->free_sem.value;
+}
+
+/**
+ * @brief CPU 写完、交给 DMA 读取之前调用：把缓存中的数据写回内存。
+ *        未开启 RT_USING_CACHE（无数据缓存或缓冲区位于不可缓存区域）时为空操作。
+ */
+rt_inline void dma_pool_sync_for_device(dma_pool_t dp, void *buf, rt_size_t len)
+{
+#ifdef RT_USING_CACHE
+    rt_hw_cpu_dcache_ops(RT_HW_CACHE_FLUSH, buf, (int)RT_ALIGN(len, dp->align));
+#endif
+    (void)dp;
+    (void)buf;
+    (void)len;
+}
+
+/**
+ * @brief DMA 写完、CPU 读取之前调用：丢弃缓存中的旧数据。
+ *        未开启 RT_USING_CACHE 时为空操作。
+ */
+rt_inline void dma_pool_sync_for_cpu(dma_pool_t dp, void *buf, rt_size_t len)
+{
+#ifdef RT_USING_CACHE
+    rt_hw_cpu_dcache_ops(RT_HW_CACHE_INVALIDATE, buf, (int)RT_ALIGN(len, dp->align));
+#endif
+    (void)dp;
+    (void)buf;
+    (void)len;
+}
+
+/**
+ * @brief 经邮箱按引用投递缓冲区（邮件即缓冲区地址），可在中断中调用。
+ */
+rt_inline rt_err_t dma_pool_post_mb(rt_mailbox_t mb, void *buf)
+{
+    return rt_mb_send(mb, (rt_ubase_t)buf);
+}
+
+/**
+ * @brief 经消息队列按引用投递缓冲区描述，队列的消息大小应为 `sizeof(struct dma_buf_desc)`。
+ */
+rt_inline rt_err_t dma_pool_post_mq(rt_mq_t mq, void *buf, rt_uint32_t len, rt_ubase_t user_data)
+{
+    struct dma_buf_desc desc;
+
+    desc.buf = buf;
+    desc.len = len;
+    desc.user_data = user_data;
+    return rt_mq_send(mq, &desc, sizeof(desc));
+}
+
+/**
+ * 三重缓冲：生产者与消费者各持有一个缓冲区，第三个作为交换区。
+ * 生产者写完后把自己的缓冲区与交换区原子交换并标记“有新帧”，消费者读取时若有新帧
+ * 再把自己的缓冲区与交换区交换。生产者总有空闲缓冲区可写，消费者总拿到最近一次写完的帧，
+ * 双方都不阻塞；消费者来不及读的中间帧被直接覆盖。适用于一个生产者、一个消费者。
+ */
+#define TRIPLE_BUFFER_INDEX  0x3U
+#define TRIPLE_BUFFER_FRESH  0x4U   /* 交换区中是消费者尚未取走的新帧 */
+
+struct triple_buffer
+{
+    volatile rt_uint32_t middle;    /* 交换区编号 | TRIPLE_BUFFER_FRESH */
+    rt_uint8_t back;                /* 生产者持有，仅生产者访问 */
+    rt_uint8_t front;               /* 消费者持有，仅消费者访问 */
+    rt_bool_t front_valid;          /* 消费者是否已取得过帧 */
+    rt_uint8_t *base;
+    rt_size_t stride;
+    rt_bool_t is_dynamic;
+};
+typedef struct triple_buffer *triple_buffer_t;
+
+/* 静态创建时 `buffers` 所需的字节数 */
+#define TRIPLE_BUFFER_POOL_SIZE(buf_size) (3 * RT_ALIGN((buf_size), RT_ALIGN_SIZE))
+
+/**
+ * @brief 创建或初始化一个三重缓冲，支持动态和静态创建。
+ *
+ * @param[in,out] tb_ptr      指向三重缓冲控制块的指针。
+ *                            - 若 `is_dynamic` 为 `RT_FALSE`（静态创建），
+ *                              则需传入已分配的控制块地址。可定义全局：`struct triple_buffer frames;`
+ *                            - 若 `is_dynamic` 为 `RT_TRUE`（动态创建），
+ *                              则传入一个值 `RT_NULL` 的指针，控制块与三个缓冲区一次性动态分配。可定义全局：`triple_buffer_t frames = RT_NULL;`
+ * @param[in]     buffers     静态创建时由用户分配 `TRIPLE_BUFFER_POOL_SIZE(buf_size)` 字节并按 `RT_ALIGN_SIZE` 对齐；
+ *                            动态创建时传入 `RT_NULL`。
+ * @param[in]     buf_size    单个缓冲区（一帧）的大小。
+ * @param[in]     is_dynamic  指示是否动态创建。
+ *
+ * @return `RT_EOK` 表示成功，`-ENOMEM` 表示内存不足导致动态创建失败。
+ *
+ * @note 动态创建的三重缓冲不再使用时调用 `triple_buffer_delete`，静态创建的无需销毁。
+ */
+rt_err_t triple_buffer_generator(triple_buffer_t *tb_ptr,
+                                 void *buffers,
+                                 rt_size_t buf_size,
+                                 rt_bool_t is_dynamic)
+{
+    if (is_dynamic)
+    {
+        rt_size_t head = RT_ALIGN(sizeof(struct triple_buffer), RT_ALIGN_SIZE);
+
+        *tb_ptr = (triple_buffer_t)repack_malloc(head + TRIPLE_BUFFER_POOL_SIZE(buf_size));
+        if (*tb_ptr == RT_NULL)
+        {
+            LOG_E("triple_buffer malloc failed...\n");
+            return -ENOMEM;
+        }
+        buffers = (rt_uint8_t *)(*tb_ptr) + head;
+        repack_heap_tag(*tb_ptr, head + TRIPLE_BUFFER_POOL_SIZE(buf_size), REPACK_HEAP_TRIPLE_BUFFER, RT_NULL);
+    }
+    (*tb_ptr)->back = 0;
+    (*tb_ptr)->middle = 1;
+    (*tb_ptr)->front = 2;
+    (*tb_ptr)->front_valid = RT_FALSE;
+    (*tb_ptr)->base = (rt_uint8_t *)buffers;
+    (*tb_ptr)->stride = RT_ALIGN(buf_size, RT_ALIGN_SIZE);
+    (*tb_ptr)->is_dynamic = is_dynamic;
+    return RT_EOK;
+}
+
+/**
+ * @brief 删除动态创建的三重缓冲并释放内存。
+ */
+rt_err_t triple_buffer_delete(triple_buffer_t tb)
+{
+    RT_ASSERT(tb != RT_NULL && tb->is_dynamic == RT_TRUE);
+    repack_heap_untag(tb);
+    repack_free(tb);
+    return RT_EOK;
+}
+
+/**
+ * @brief 生产者取得当前可写的缓冲区。提交之前可反复调用，返回同一个缓冲区。
+ */
+rt_inline void *triple_buffer_write_buf(triple_buffer_t tb)
+{
+    return tb->base + tb->back * tb->stride;
+}
+
+/**
+ * @brief 生产者提交写完的帧，随后 `triple_buffer_write_buf` 返回另一个空闲缓冲区。
+ *        可在中断（如 DMA 帧完成中断）中调用。
+ */
+rt_inline void triple_buffer_commit(triple_buffer_t tb)
+{
+    tb->back = (rt_uint8_t)(repack_atomic_xchg(&tb->middle, tb->back | TRIPLE_BUFFER_FRESH) & TRIPLE_BUFFER_INDEX);
+}
+
+/**
+ * @brief 消费者取得最近一次提交的帧。返回的缓冲区在下一次调用前保持不变，可放心读取。
+ *
+ * @param[out] fresh  可选，返回的帧是否是上次调用之后新提交的，不需要时传 `RT_NULL`。
+ *
+ * @return 帧缓冲区，生产者还未提交过任何帧时返回 `RT_NULL`。
+ */
+rt_inline const void *triple_buffer_read(triple_buffer_t tb, rt_bool_t *fresh)
+{
+    rt_bool_t updated = RT_FALSE;
+
+    if (tb->middle & TRIPLE_BUFFER_FRESH)
+    {
+        tb->front = (rt_uint8_t)(repack_atomic_xchg(&tb->middle, tb->front) & TRIPLE_BUFFER_INDEX);
+        tb->front_valid = RT_TRUE;
+        updated = RT_TRUE;
+    }
+    if (fresh != RT_NULL)
+        *fresh = updated;
+    return tb->front_valid ? tb->base + tb->front * tb->stride : RT_NULL;
+}
+
+/**
+ * @brief  声明一种消息布局（schema），一次声明即生成零拷贝访问视图。
+ *
+ * 字段表以 X-Macro 形式给出，每行为 `X(schema, field, type)`，展开后生成：
+ *   - `struct schema`：消息在队列槽中的内存布局；
+ *   - `schema##_view(slot)` / `schema##_cview(slot)`：把槽指针视为该布局的可写 / 只读视图；
+ *   - `schema##_get_##field(slot)` / `schema##_set_##field(slot, v)`：逐字段访问器；
+ *   - `schema##_size`：布局大小，可直接作为 `inplace_mq_generator` 的 `msg_size`。
+ *
+ * @code
+ * #define SENSOR_MSG_FIELDS(X)             \
+ *     X(sensor_msg, id,    rt_uint16_t)    \
+ *     X(sensor_msg, value, rt_int32_t)
+ * MSG_SCHEMA_DEFINE(sensor_msg, SENSOR_MSG_FIELDS);
+ * @endcode
+ *
+ * @note  访问器直接读写槽内存，不做拷贝与反序列化；槽由 `inplace_mq_alloc` 分配，
+ *        按 `RT_ALIGN_SIZE` 对齐，布局内字段按编译器默认规则对齐。
+ */
+#define MSG_SCHEMA_MEMBER(schema, field, type) type field;
+#define MSG_SCHEMA_ACCESSOR(schema, field, type)                \
+    rt_inline type schema##_get_##field(const void *slot)       \
+    {                                                           \
+        return ((const struct schema *)slot)->field;            \
+    }                                                           \
+    rt_inline void schema##_set_##field(void *slot, type value) \
+    {                                                           \
+        ((struct schema *)slot)->field = value;                 \
+    }
+#define MSG_SCHEMA_DEFINE(schema, FIELDS)                        \
+    struct schema                                                \
+    {                                                            \
+        FIELDS(MSG_SCHEMA_MEMBER)                                \
+    };                                                           \
+    rt_inline struct schema *schema##_view(void *slot)           \
+    {                                                            \
+        return (struct schema *)slot;                            \
+    }                                                            \
+    rt_inline const struct schema *schema##_cview(const void *slot) \
+    {                                                            \
+        return (const struct schema *)slot;                      \
+    }                                                            \
+    FIELDS(MSG_SCHEMA_ACCESSOR)                                  \
+    enum { schema##_size = sizeof(struct schema) }
+
+#ifdef RT_USING_MEMPOOL
+/**
+ * 就地消息队列：消息槽来自内存池，邮箱只传递槽指针。
+ * 生产者在槽内直接填写字段后投递，消费者收到槽指针后通过 schema 视图直接读取，
+ * 全程不发生消息体拷贝。
+ */
+struct inplace_mq
+{
+    struct rt_mailbox mb;   /* 传递槽指针，容量与槽数相同，投递不会因满而失败 */
+    struct rt_mempool pool; /* 消息槽 */
+    rt_bool_t is_dynamic;
+};
+typedef struct inplace_mq *inplace_mq_t;
+
+/* 静态创建时 `msgpool` 所需的字节数：邮箱指针区 + 内存池槽区（每槽含一个指针大小的块头） */
+#define INPLACE_MQ_POOL_SIZE(msg_size, max_msgs)                          \
+    ((max_msgs) * sizeof(rt_ubase_t) +                                    \
+     (max_msgs) * (RT_ALIGN((msg_size), RT_ALIGN_SIZE) + sizeof(rt_uint8_t *)))
+
+/**
+ * @brief 创建或初始化一个就地消息队列，支持动态和静态创建。
+ *
+ * @param[in,out] mq_ptr         指向就地消息队列控制块的指针。
+ *                               - 若 `is_dynamic` 为 `RT_FALSE`（静态创建），
+ *                                 则需传入已分配的控制块地址。可定义全局：`struct inplace_mq mq;`
+ *                               - 若 `is_dynamic` 为 `RT_TRUE`（动态创建），
+ *                                 则传入一个值 `RT_NULL` 的指针，控制块与消息池一次性动态分配。可定义全局：`inplace_mq_t mq = RT_NULL;`
+ * @param[in]     name           队列名称（邮箱与内存池共用）。
+ * @param[in]     msgpool        消息池指针，静态创建时由用户分配 `INPLACE_MQ_POOL_SIZE(msg_size, max_msgs)` 字节
+ *                               并按 `RT_ALIGN_SIZE` 对齐；动态创建时传入 `RT_NULL`。
+ * @param[in]     msg_size       单个消息槽的大小（字节数），通常为 `schema##_size`。
+ * @param[in]     max_msgs       消息槽数量。
+ * @param[in]     flag           等待队列标志，支持 `RT_IPC_FLAG_FIFO` 或 `RT_IPC_FLAG_PRIO`。
+ * @param[in]     is_dynamic     指示是否动态创建。
+ *
+ * @return `RT_EOK` 表示成功，其他错误代码表示失败：
+ *         - `-ENOMEM`：内存不足导致动态创建失败。
+ *         - 非 `RT_EOK`：静态创建失败。
+ *
+ * @note 动态创建的队列不再使用时调用 `inplace_mq_delete`，静态创建的调用 `inplace_mq_detach`。
+ */
+rt_err_t inplace_mq_generator(inplace_mq_t *mq_ptr,
+                              const char *name,
+                              void *msgpool,
+                              rt_size_t msg_size,
+                              rt_size_t max_msgs,
+                              rt_uint8_t flag,
+                              rt_bool_t is_dynamic)
+{
+    rt_size_t mb_bytes = max_msgs * sizeof(rt_ubase_t);
+    rt_size_t pool_bytes = INPLACE_MQ_POOL_SIZE(msg_size, max_msgs) - mb_bytes;
+    rt_size_t head = RT_ALIGN(sizeof(struct inplace_mq), RT_ALIGN_SIZE);
+    int ret = RT_EOK;
+
+    if (is_dynamic)
+    {
+        *mq_ptr = (inplace_mq_t)repack_malloc(head + mb_bytes + pool_bytes);
+        if (*mq_ptr == RT_NULL)
+        {
+            LOG_E("inplace_mq malloc failed...\n");
+            return -ENOMEM;
+        }
+        msgpool = (rt_uint8_t *)(*mq_ptr) + head;
+    }
+
+    ret = rt_mb_init(&(*mq_ptr)->mb, name, msgpool, max_msgs, flag);
+    if (ret != RT_EOK)
+    {
+        LOG_E("inplace_mq rt_mb_init failed...\n");
+        goto __fail;
+    }
+    ret = rt_mp_init(&(*mq_ptr)->pool, name, (rt_uint8_t *)msgpool + mb_bytes, pool_bytes, msg_size);
+    if (ret != RT_EOK)
+    {
+        LOG_E("inplace_mq rt_mp_init failed...\n");
+        rt_mb_detach(&(*mq_ptr)->mb);
+        goto __fail;
+    }
+    (*mq_ptr)->is_dynamic = is_dynamic;
+    LOG_D("inplace_mq init succeeded...\n");
+    repack_object_created(&(*mq_ptr)->mb.parent.parent, RT_FALSE);
+    if (is_dynamic)
+        repack_heap_tag(*mq_ptr, head + mb_bytes + pool_bytes, REPACK_HEAP_INPLACE_MQ, name);
+    return RT_EOK;
+
+__fail:
+    if (is_dynamic)
+    {
+        repack_free(*mq_ptr);
+        *mq_ptr = RT_NULL;
+    }
+    return ret;
+}
+
+/**
+ * @brief 脱离静态创建的就地消息队列。
+ */
+rt_err_t inplace_mq_detach(inplace_mq_t mq)
+{
+    RT_ASSERT(mq != RT_NULL && mq->is_dynamic == RT_FALSE);
+    rt_mp_detach(&mq->pool);
+    return rt_mb_detach(&mq->mb);
+}
+
+/**
+ * @brief 删除动态创建的就地消息队列并释放内存。
+ */
+rt_err_t inplace_mq_delete(inplace_mq_t mq)
+{
+    RT_ASSERT(mq != RT_NULL && mq->is_dynamic == RT_TRUE);
+    rt_mp_detach(&mq->pool);
+    rt_mb_detach(&mq->mb);
+    repack_heap_untag(mq);
+    repack_free(mq);
+    return RT_EOK;
+}
+
+/**
+ * @brief 生产者申请一个空闲消息槽，随后通过 schema 视图就地填写。
+ *
+ * @param[in] timeout  无空闲槽时的等待时间，中断中只能传 `RT_WAITING_NO`。
+ * @return 槽指针，超时返回 `RT_NULL`。
+ */
+rt_inline void *inplace_mq_alloc(inplace_mq_t mq, rt_int32_t timeout)
+{
+    return rt_mp_alloc(&mq->pool, timeout);
+}
+
+/**
+ * @brief 投递一个已填写的消息槽。槽的所有权转移给接收方。
+ */
+rt_inline rt_err_t inplace_mq_send(inplace_mq_t mq, void *slot)
+{
+    return rt_mb_send(&mq->mb, (rt_ubase_t)slot);
+}
+
+/**
+ * @brief 就地接收：取得队首消息槽的指针，不拷贝消息体。
+ *
+ * @param[out] slot    接收到的槽指针，读取完毕后必须调用 `inplace_mq_release` 归还。
+ * @param[in]  timeout 等待时间。
+ */
+rt_inline rt_err_t inplace_mq_recv(inplace_mq_t mq, void **slot, rt_int32_t timeout)
+{
+    rt_ubase_t value = 0;
+    rt_err_t ret = rt_mb_recv(&mq->mb, &value, timeout);
+
+    *slot = (ret == RT_EOK) ? (void *)value : RT_NULL;
+    return ret;
+}
+
+/**
+ * @brief 归还消息槽，可在任意线程或中断中调用。
+ */
+rt_inline void inplace_mq_release(void *slot)
+{
+    rt_mp_free(slot);
+}
+#endif /* RT_USING_MEMPOOL */
+
+/**
+ * 可回收的完成信号量缓存：一组预先初始化的二值信号量，请求方借出一个用于等待应答，
+ * 完成后归还并清零，借出与归还都是 O(1) 的出栈/入栈，不再有每次请求的
+ * 内存分配与对象链表操作。
+ */
+struct sem_cache
+{
+    rt_sem_t *free;             /* 空闲栈，free[0..top) 为可借出的信号量 */
+    struct rt_semaphore *sems;
+    rt_uint16_t count;
+    rt_uint16_t top;
+    repack_lock_t lock;         /* 保护空闲栈 */
+    rt_bool_t is_dynamic;
+};
+typedef struct sem_cache *sem_cache_t;
+
+/* 静态创建时 `pool` 所需的字节数：信号量控制块区 + 空闲栈 */
+#define SEM_CACHE_POOL_SIZE(count) ((count) * (sizeof(struct rt_semaphore) + sizeof(rt_sem_t)))
+
+/**
+ * @brief 创建或初始化一个完成信号量缓存，支持动态和静态创建。
+ *
+ * @param[in,out] cache_ptr      指向缓存控制块的指针。
+ *                               - 若 `is_dynamic` 为 `RT_FALSE`（静态创建），
+ *                                 则需传入已分配的控制块地址。可定义全局：`struct sem_cache cache;`
+ *                               - 若 `is_dynamic` 为 `RT_TRUE`（动态创建），
+ *                                 则传入一个值 `RT_NULL` 的指针，控制块与信号量一次性动态分配。可定义全局：`sem_cache_t cache = RT_NULL;`
+ * @param[in]     name           信号量名称（缓存中的信号量共用）。
+ * @param[in]     pool           静态创建时由用户分配 `SEM_CACHE_POOL_SIZE(count)` 字节并按 `RT_ALIGN_SIZE` 对齐；
+ *                               动态创建时传入 `RT_NULL`。
+ * @param[in]     count          缓存的信号量个数，即同时在途的请求数上限。
+ * @param[in]     flag           等待队列标志，支持 `RT_IPC_FLAG_FIFO` 或 `RT_IPC_FLAG_PRIO`。
+ * @param[in]     is_dynamic     指示是否动态创建。
+ *
+ * @return `RT_EOK` 表示成功，其他错误代码表示失败：
+ *         - `-ENOMEM`：内存不足导致动态创建失败。
+ *         - 非 `RT_EOK`：静态创建失败。
+ *
+ * @note 动态创建的缓存不再使用时调用 `sem_cache_delete`，静态创建的调用 `sem_cache_detach`。
+ */
+rt_err_t sem_cache_generator(sem_cache_t *cache_ptr,
+                             const char *name,
+                             void *pool,
+                             rt_uint16_t count,
+                             rt_uint8_t flag,
+                             rt_bool_t is_dynamic)
+{
+    rt_size_t bytes = RT_ALIGN(sizeof(struct sem_cache), RT_ALIGN_SIZE) + SEM_CACHE_POOL_SIZE(count);
+    rt_uint16_t i;
+    int ret = RT_EOK;
+
+    if (is_dynamic)
+    {
+        *cache_ptr = (sem_cache_t)repack_malloc(bytes);
+        if (*cache_ptr == RT_NULL)
+        {
+            LOG_E("sem_cache malloc failed...\n");
+            return -ENOMEM;
+        }
+        pool = (rt_uint8_t *)(*cache_ptr) + RT_ALIGN(sizeof(struct sem_cache), RT_ALIGN_SIZE);
+    }
+
+    (*cache_ptr)->sems = (struct rt_semaphore *)pool;
+    (*cache_ptr)->free = (rt_sem_t *)((*cache_ptr)->sems + count);
+    (*cache_ptr)->count = count;
+    (*cache_ptr)->top = count;
+    (*cache_ptr)->is_dynamic = is_dynamic;
+    repack_lock_init(&(*cache_ptr)->lock);
+    for (i = 0; i < count; i++)
+    {
+        ret = rt_sem_init(&(*cache_ptr)->sems[i], name, 0, flag);
+        if (ret != RT_EOK)
+            break;
+        (*cache_ptr)->free[i] = &(*cache_ptr)->sems[i];
+        repack_object_created(&(*cache_ptr)->sems[i].parent.parent, RT_FALSE);
+    }
+    if (ret != RT_EOK)
+    {
+        LOG_E("sem_cache rt_sem_init failed...\n");
+        while (i-- > 0)
+            rt_sem_detach(&(*cache_ptr)->sems[i]);
+        if (is_dynamic)
+        {
+            repack_free(*cache_ptr);
+            *cache_ptr = RT_NULL;
+        }
+        return ret;
+    }
+    if (is_dynamic)
+        repack_heap_tag(*cache_ptr, bytes, REPACK_HEAP_SEM_CACHE, name);
+    LOG_D("sem_cache init succeeded...\n");
+    return RT_EOK;
+}
+
+/**
+ * @brief 脱离静态创建的完成信号量缓存，调用前应归还全部信号量。
+ */
+rt_err_t sem_cache_detach(sem_cache_t cache)
+{
+    rt_uint16_t i;
+
+    RT_ASSERT(cache != RT_NULL && cache->is_dynamic == RT_FALSE);
+    for (i = 0; i < cache->count; i++)
+        rt_sem_detach(&cache->sems[i]);
+    return RT_EOK;
+}
+
+/**
+ * @brief 删除动态创建的完成信号量缓存并释放内存，调用前应归还全部信号量。
+ */
+rt_err_t sem_cache_delete(sem_cache_t cache)
+{
+    rt_uint16_t i;
+
+    RT_ASSERT(cache != RT_NULL && cache->is_dynamic == RT_TRUE);
+    for (i = 0; i < cache->count; i++)
+        rt_sem_detach(&cache->sems[i]);
+    repack_heap_untag(cache);
+    repack_free(cache);
+    return RT_EOK;
+}
+
+/**
+ * @brief 借出一个计数为 0 的信号量，可在中断中调用。
+ *
+ * @return 信号量，缓存已借空时返回 `RT_NULL`。
+ */
+rt_inline rt_sem_t sem_cache_borrow(sem_cache_t cache)
+{
+    rt_sem_t sem = RT_NULL;
+    rt_base_t level = repack_lock(&cache->lock);
+
+    if (cache->top > 0)
+        sem = cache->free[--cache->top];
+    repack_unlock(&cache->lock, level);
+    return sem;
+}
+
+/**
+ * @brief 归还信号量，计数清零后放回缓存。
+ *
+ * 等待超时后应答方可能仍会释放一次，归还时清零可避免下一个借用者被误唤醒；
+ * 但归还之后应答方不得再释放该信号量。
+ */
+rt_inline void sem_cache_return(sem_cache_t cache, rt_sem_t sem)
+{
+    rt_base_t level;
+
+    rt_sem_control(sem, RT_IPC_CMD_RESET, RT_NULL);
+    level = repack_lock(&cache->lock);
+    RT_ASSERT(cache->top < cache->count);
+    cache->free[cache->top++] = sem;
+    repack_unlock(&cache->lock, level);
+}
+
+#ifdef RT_USING_DEVICE_IPC
+#include <rtdevice.h>
+
+/**
+ * 一次性完成通知：对 components/drivers/ipc 中 `rt_completion` 的薄封装。
+ * `rt_completion` 不带名称，也不进入内核对象链表，只有一个完成标志与一个等待者
+ * （5.1 起二者合并在一个字里），适用于“某件事做完了”这类只有一个等待者的握手，
+ * 比信号量少了对象管理与计数语义的开销。
+ * 一次成功的等待会消耗完成状态；无人等待时的完成保留到下一次等待，或由 `completion_reinit` 清除。
+ */
+struct completion
+{
+    struct rt_completion comp;
+    rt_bool_t is_dynamic;
+};
+typedef struct completion *completion_t;
+
+/**
+ * @brief 创建或初始化一个完成通知，支持动态和静态创建。
+ *
+ * @param[in,out] comp_ptr    指向完成通知控制块的指针。
+ *                            - 若 `is_dynamic` 为 `RT_FALSE`（静态创建），
+ *                              则需传入已分配的控制块地址。可定义全局：`struct completion done;`
+ *                            - 若 `is_dynamic` 为 `RT_TRUE`（动态创建），
+ *                              则传入一个值 `RT_NULL` 的指针即可。可定义全局：`completion_t done = RT_NULL;`
+ * @param[in]     is_dynamic  指示是否动态创建。
+ *
+ * @return `RT_EOK` 表示成功，`-ENOMEM` 表示内存不足导致动态创建失败。
+ *
+ * @note 动态创建的完成通知不再使用时调用 `completion_delete`，静态创建的无需销毁。
+ */
+rt_err_t completion_generator(completion_t *comp_ptr, rt_bool_t is_dynamic)
+{
+    if (is_dynamic)
+    {
+        *comp_ptr = (completion_t)repack_malloc(sizeof(struct completion));
+        if (*comp_ptr == RT_NULL)
+        {
+            LOG_E("completion malloc failed...\n");
+            return -ENOMEM;
+        }
+        repack_heap_tag(*comp_ptr, sizeof(struct completion), REPACK_HEAP_COMPLETION, RT_NULL);
+    }
+    rt_completion_init(&(*comp_ptr)->comp);
+    (*comp_ptr)->is_dynamic = is_dynamic;
+    return RT_EOK;
+}
+
+/**
+ * @brief 删除动态创建的完成通知，此时不应再有等待者。
+ */
+rt_err_t completion_delete(completion_t comp)
+{
+    RT_ASSERT(comp != RT_NULL && comp->is_dynamic == RT_TRUE);
+    repack_heap_untag(comp);
+    repack_free(comp);
+    return RT_EOK;
+}
+
+/**
+ * @brief 把完成通知恢复为未完成状态以便再次使用，此时不应再有等待者。
+ */
+rt_inline void completion_reinit(completion_t comp)
+{
+    rt_completion_init(&comp->comp);
+}
+
+/**
+ * @brief 等待完成。同一时刻只允许一个线程等待，不能在中断中调用。
+ *
+ * @param[in] timeout  等待时间（tick），`RT_WAITING_FOREVER` 为一直等待，0 为只查询不等待。
+ *
+ * @return `RT_EOK` 表示已完成，`-RT_ETIMEOUT` 表示超时，其他值同 `rt_completion_wait`。
+ */
+rt_inline rt_err_t completion_wait(completion_t comp, rt_int32_t timeout)
+{
+    return rt_completion_wait(&comp->comp, timeout);
+}
+
+/**
+ * @brief 标记完成并唤醒等待者，可在中断中调用，重复调用无副作用。
+ */
+rt_inline void completion_done(completion_t comp)
+{
+    rt_completion_done(&comp->comp);
+}
+
+/**
+ * 字节流缓冲：单生产者/单消费者的字节环形缓冲，读写任意长度。
+ * 读写两端各自只修改自己的位置，快速路径无锁；读端阻塞时登记所需字节数，
+ * 写端只在缓冲区中的数据达到该数量时才唤醒读端（按触发水位而非逐字节唤醒），写端满时同理。
+ * 唤醒使用完成通知，适合 UART、音频等由中断写入、线程成批读取的字节流。
+ */
+struct stream_buffer
+{
+    volatile rt_uint32_t head;      /* 读位置，仅读端写 */
+    volatile rt_uint32_t tail;      /* 写位置，仅写端写 */
+    rt_uint32_t mask;
+    rt_uint32_t trigger;            /* 读端被唤醒所需的最少字节数 */
+    volatile rt_uint32_t rx_level;  /* 读端正在等待的字节数，0 为未等待 */
+    volatile rt_uint32_t tx_level;  /* 写端正在等待的空位数，0 为未等待 */
+    struct completion rx_done;
+    struct completion tx_done;
+    rt_uint8_t *buf;
+    rt_bool_t is_dynamic;
+};
+typedef struct stream_buffer *stream_buffer_t;
+
+/**
+ * @brief 创建或初始化一个字节流缓冲，支持动态和静态创建。
+ *
+ * @param[in,out] sb_ptr      指向字节流缓冲控制块的指针。
+ *                            - 若 `is_dynamic` 为 `RT_FALSE`（静态创建），
+ *                              则需传入已分配的控制块地址。可定义全局：`struct stream_buffer rx;`
+ *                            - 若 `is_dynamic` 为 `RT_TRUE`（动态创建），
+ *                              则传入一个值 `RT_NULL` 的指针，控制块与缓冲区一次性动态分配。可定义全局：`stream_buffer_t rx = RT_NULL;`
+ * @param[in]     buffer      静态创建时的缓冲区，`size` 字节；动态创建时传入 `RT_NULL`。
+ * @param[in]     size        缓冲区大小，须为 2 的幂。
+ * @param[in]     trigger     触发水位：读端至少等到这么多字节才被唤醒（不超过本次要读的长度），最小为 1。
+ * @param[in]     is_dynamic  指示是否动态创建。
+ *
+ * @return `RT_EOK` 表示成功，其他错误代码表示失败：
+ *         - `-ENOMEM`：内存不足导致动态创建失败。
+ *         - `-RT_EINVAL`：大小不是 2 的幂。
+ *
+ * @note 动态创建的字节流缓冲不再使用时调用 `stream_buffer_delete`，静态创建的无需销毁。
+ */
+rt_err_t stream_buffer_generator(stream_buffer_t *sb_ptr,
+                                 void *buffer,
+                                 rt_uint32_t size,
+                                 rt_uint32_t trigger,
+                                 rt_bool_t is_dynamic)
+{
+    completion_t comp;
+
+    if (size == 0 || (size & (size - 1)) != 0)
+    {
+        LOG_E("stream_buffer size must be a power of two...\n");
+        return -RT_EINVAL;
+    }
+    if (is_dynamic)
+    {
+        rt_size_t head = RT_ALIGN(sizeof(struct stream_buffer), RT_ALIGN_SIZE);
+
+        *sb_ptr = (stream_buffer_t)repack_malloc(head + size);
+        if (*sb_ptr == RT_NULL)
+        {
+            LOG_E("stream_buffer malloc failed...\n");
+            return -ENOMEM;
+        }
+        buffer = (rt_uint8_t *)(*sb_ptr) + head;
+        repack_heap_tag(*sb_ptr, head + size, REPACK_HEAP_STREAM_BUFFER, RT_NULL);
+    }
+    (*sb_ptr)->head = (*sb_ptr)->tail = 0;
+    (*sb_ptr)->mask = size - 1;
+    (*sb_ptr)->trigger = trigger ? trigger : 1;
+    (*sb_ptr)->rx_level = (*sb_ptr)->tx_level = 0;
+    (*sb_ptr)->buf = (rt_uint8_t *)buffer;
+    (*sb_ptr)->is_dynamic = is_dynamic;
+    comp = &(*sb_ptr)->rx_done;
+    completion_generator(&comp, RT_FALSE);
+    comp = &(*sb_ptr)->tx_done;
+    completion_generator(&comp, RT_FALSE);
+    return RT_EOK;
+}
+
+/**
+ * @brief 删除动态创建的字节流缓冲并释放内存。
+ */
+rt_err_t stream_buffer_delete(stream_buffer_t sb)
+{
+    RT_ASSERT(sb != RT_NULL && sb->is_dynamic == RT_TRUE);
+    repack_heap_untag(sb);
+    repack_free(sb);
+    return RT_EOK;
+}
+
+/**
+ * @brief 修改触发水位，读端下一次等待时生效。
+ */
+rt_inline void stream_buffer_set_trigger(stream_buffer_t sb, rt_uint32_t trigger)
+{
+    sb->trigger = trigger ? trigger : 1;
+}
+
+/**
+ * @brief 缓冲区中可读的字节数。
+ */
+rt_inline rt_uint32_t stream_buffer_available(stream_buffer_t sb)
+{
+    return repack_atomic_load(&sb->tail) - repack_atomic_load(&sb->head);
+}
+
+/* 对端登记的水位已满足时唤醒对端，只有一方能取走登记 */
+rt_inline void stream_buffer_notify(volatile rt_uint32_t *level, rt_uint32_t have, completion_t comp)
+{
+    rt_uint32_t want;
+
+    repack_atomic_fence();
+    want = *level;
+    if (want != 0 && have >= want && repack_atomic_xchg(level, 0) != 0)
+        completion_done(comp);
+}
+
+/*
+ * 等到 *count() 达到 want 或超时：先登记水位再检查一次，避免在检查之后、等待之前的通知丢失。
+ * 返回最后一次检查到的数量。
+ */
+static rt_uint32_t stream_buffer_wait(stream_buffer_t sb, volatile rt_uint32_t *level, completion_t comp,
+                                      rt_uint32_t (*count)(stream_buffer_t), rt_uint32_t want, rt_int32_t timeout)
+{
+    rt_tick_t deadline = rt_tick_get() + (rt_tick_t)timeout;
+    rt_uint32_t have = count(sb);
+
+    while (have < want && timeout != 0)
+    {
+        rt_int32_t remain = RT_WAITING_FOREVER;
+
+        if (timeout != RT_WAITING_FOREVER)
+        {
+            remain = (rt_int32_t)(deadline - rt_tick_get());
+            if (remain <= 0)
+                break;
+        }
+        completion_reinit(comp);
+        repack_atomic_xchg(level, want);
+        repack_atomic_fence();
+        have = count(sb);
+        if (have < want)
+            completion_wait(comp, remain);
+        repack_atomic_xchg(level, 0);
+        have = count(sb);
+    }
+    return have;
+}
+
+static rt_uint32_t stream_buffer_space(stream_buffer_t sb)
+{
+    return sb->mask + 1 - stream_buffer_available(sb);
+}
+
+/* 写入不超过空位的数据，返回写入的字节数 */
+static rt_uint32_t stream_buffer_put(stream_buffer_t sb, const rt_uint8_t *data, rt_uint32_t len)
+{
+    rt_uint32_t tail = sb->tail;
+    rt_uint32_t space = sb->mask + 1 - (tail - repack_atomic_load(&sb->head));
+    rt_uint32_t offset = tail & sb->mask;
+    rt_uint32_t first;
+
+    if (len > space)
+        len = space;
+    first = sb->mask + 1 - offset;
+    if (first > len)
+        first = len;
+    rt_memcpy(sb->buf + offset, data, first);
+    rt_memcpy(sb->buf, data + first, len - first);
+    repack_atomic_store(&sb->tail, tail + len);
+    return len;
+}
+
+/* 读出不超过可读量的数据，返回读出的字节数 */
+static rt_uint32_t stream_buffer_get(stream_buffer_t sb, rt_uint8_t *data, rt_uint32_t len)
+{
+    rt_uint32_t head = sb->head;
+    rt_uint32_t avail = repack_atomic_load(&sb->tail) - head;
+    rt_uint32_t offset = head & sb->mask;
+    rt_uint32_t first;
+
+    if (len > avail)
+        len = avail;
+    first = sb->mask + 1 - offset;
+    if (first > len)
+        first = len;
+    rt_memcpy(data, sb->buf + offset, first);
+    rt_memcpy(data + first, sb->buf, len - first);
+    repack_atomic_store(&sb->head, head + len);
+    return len;
+}
+
+/**
+ * @brief 写入数据（写端）。空位不足时按 timeout 等待读端腾出空间；
+ *        `timeout` 为 `RT_WAITING_NO` 时只写入能放下的部分，可在中断中调用。
+ *
+ * @return 写入的字节数。
+ */
+rt_uint32_t stream_buffer_send(stream_buffer_t sb, const void *data, rt_uint32_t len, rt_int32_t timeout)
+{
+    rt_tick_t deadline = rt_tick_get() + (rt_tick_t)timeout;
+    rt_uint32_t done = 0;
+
+    for (;;)
+    {
+        done += stream_buffer_put(sb, (const rt_uint8_t *)data + done, len - done);
+        stream_buffer_notify(&sb->rx_level, stream_buffer_available(sb), &sb->rx_done);
+        if (done == len || timeout == 0)
+            break;
+        if (timeout != RT_WAITING_FOREVER)
+        {
+            rt_int32_t remain = (rt_int32_t)(deadline - rt_tick_get());
+
+            if (remain <= 0)
+                break;
+            timeout = remain;
+        }
+        // 等到能放下剩余数据（或整个缓冲区腾空）再继续，避免逐字节唤醒
+        if (stream_buffer_wait(sb, &sb->tx_level, &sb->tx_done, stream_buffer_space,
+                               (len - done < sb->mask + 1) ? len - done : sb->mask + 1, timeout) == 0)
+            break;
+    }
+    return done;
+}
+
+/**
+ * @brief 读取数据（读端）。可读数据少于 min(触发水位, len) 时按 timeout 等待，
+ *        超时后返回已有的数据。
+ *
+ * @return 读出的字节数，超时且无数据时为 0。
+ */
+rt_uint32_t stream_buffer_recv(stream_buffer_t sb, void *data, rt_uint32_t len, rt_int32_t timeout)
+{
+    rt_uint32_t want = (sb->trigger < len) ? sb->trigger : len;
+    rt_uint32_t n;
+
+    if (want > sb->mask + 1)
+        want = sb->mask + 1;
+    stream_buffer_wait(sb, &sb->rx_level, &sb->rx_done, stream_buffer_available, want, timeout);
+    n = stream_buffer_get(sb, (rt_uint8_t *)data, len);
+    if (n != 0)
+        stream_buffer_notify(&sb->tx_level, stream_buffer_space(sb), &sb->tx_done);
+    return n;
+}
+#endif /* RT_USING_DEVICE_IPC */
+
+#ifdef RTREPACK_USING_IPC_CAPTURE
+/*
+ * IPC 流量记录与重放。
+ *
+ * 记录：通过内核对象钩子捕获库创建的信号量、互斥量、事件集、邮箱、消息队列上的
+ * 每一次尝试获取、获取成功与释放/发送，连同负载字节数、时间戳与发起线程写入
+ * 紧凑记录缓冲区，可保存为文件。
+ * 重放：在任意后端（包括 Linux 托管的模拟器 BSP）上读取记录，按原线程、原优先级、
+ * 原时间间隔重新产生同样的流量，并可把对象替换为其他原语类型，对比等待时间与吞吐。
+ */
+#define IPC_CAPTURE_MAGIC        0x50435252 /* "RRCP" */
+#define IPC_CAPTURE_VERSION      2
+#define IPC_CAPTURE_NAME_LEN     8
+#define IPC_CAPTURE_THREAD_ISR   0x3F
+
+#define IPC_CAPTURE_OP_TRYTAKE   0
+#define IPC_CAPTURE_OP_TAKE      1
+#define IPC_CAPTURE_OP_PUT       2
+
+/* 文件头，其后依次为对象表、线程表与记录 */
+struct ipc_capture_header
+{
+    rt_uint32_t magic;
+    rt_uint16_t version;
+    rt_uint16_t record_size;
+    rt_uint32_t timestamp_freq;
+    rt_uint16_t object_count;
+    rt_uint16_t thread_count;
+    rt_uint32_t record_count;
+    rt_uint32_t dropped;
+};
+
+struct ipc_capture_object
+{
+    char name[IPC_CAPTURE_NAME_LEN];
+    rt_uint8_t type;      /* RT_Object_Class_xxx */
+    rt_uint8_t reserved;
+    rt_uint16_t msg_size; /* 单条消息字节数：消息队列为 msg_size，邮箱为一个字 */
+    rt_uint16_t capacity; /* 邮箱/消息队列容量，信号量为初始值 */
+    rt_uint16_t reserved2;
+};
+
+struct ipc_capture_thread
+{
+    char name[IPC_CAPTURE_NAME_LEN];
+    rt_uint8_t priority;
+    rt_uint8_t reserved[3];
+};
+
+/*
+ * 时间以相邻记录的间隔保存：32 位时间戳在 168 MHz 下约 25 s 回绕一次，记录间隔远小于此，
+ * 重放时逐条累加为 64 位时间轴，记录总时长不受回绕限制（单个超过一次回绕的空闲间隔会被缩短）。
+ */
+struct ipc_capture_record
+{
+    rt_uint32_t delta;     /* 距上一条记录的时间戳计数，第一条为 0 */
+    rt_uint16_t size;      /* 负载字节数：经 `ipc_capture_mq_send` 发送的为实际长度，否则为 msg_size */
+    rt_uint8_t object;     /* 对象表下标 */
+    rt_uint8_t thread_op;  /* 高 6 位为线程表下标，低 2 位为操作类型 */
+};
+
+static struct
+{
+    struct ipc_capture_header header;
+    rt_object_t handles[RTREPACK_IPC_CAPTURE_OBJECTS];
+    rt_thread_t threads_handle[RTREPACK_IPC_CAPTURE_THREADS];
+    struct ipc_capture_object objects[RTREPACK_IPC_CAPTURE_OBJECTS];
+    struct ipc_capture_thread threads[RTREPACK_IPC_CAPTURE_THREADS];
+    struct ipc_capture_record records[RTREPACK_IPC_CAPTURE_RECORDS];
+    rt_bool_t running;
+    rt_uint32_t last_stamp;    /* 上一条记录的时间戳 */
+    rt_thread_t replaying;     /* 正在创建重放对象的线程，其创建的对象不登记 */
+    rt_object_t size_object;   /* 下一次发送的实际负载长度，由 `ipc_capture_mq_send` 给出 */
+    rt_thread_t size_thread;
+    rt_uint16_t size;
+} ipc_capture_ctx;
+
+static void ipc_capture_register(rt_object_t object)
+{
+    struct ipc_capture_object *desc;
+    rt_uint8_t type = rt_object_get_type(object);
+    rt_base_t level;
+
+    if (type != RT_Object_Class_Semaphore && type != RT_Object_Class_Mutex &&
+        type != RT_Object_Class_Event && type != RT_Object_Class_MailBox &&
+        type != RT_Object_Class_MessageQueue)
+        return;
+    if (ipc_capture_ctx.replaying != RT_NULL && ipc_capture_ctx.replaying == rt_thread_self())
+        return;
+
+    level = rt_hw_interrupt_disable();
+    if (ipc_capture_ctx.header.object_count >= RTREPACK_IPC_CAPTURE_OBJECTS)
+    {
+        rt_hw_interrupt_enable(level);
+        LOG_W("ipc capture object table full, %.*s not recorded\n", RT_NAME_MAX, object->name);
+        return;
+    }
+    desc = &ipc_capture_ctx.objects[ipc_capture_ctx.header.object_count];
+    rt_memset(desc, 0, sizeof(*desc));
+    rt_strncpy(desc->name, object->name, IPC_CAPTURE_NAME_LEN);
+    desc->type = type;
+    if (type == RT_Object_Class_MessageQueue)
+    {
+        desc->msg_size = ((rt_mq_t)object)->msg_size;
+        desc->capacity = ((rt_mq_t)object)->max_msgs;
+    }
+    else if (type == RT_Object_Class_MailBox)
+    {
+        desc->msg_size = sizeof(rt_ubase_t);
+        desc->capacity = ((rt_mailbox_t)object)->size;
+    }
+    else if (type == RT_Object_Class_Semaphore)
+    {
+        desc->capacity = ((rt_sem_t)object)->value;
+    }
+    ipc_capture_ctx.handles[ipc_capture_ctx.header.object_count++] = object;
+    rt_hw_interrupt_enable(level);
+}
+
+/* 对象销毁后解除登记，表项保留以免打乱已有记录的下标 */
+static void ipc_capture_unregister(rt_object_t object)
+{
+    rt_uint16_t i;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    for (i = 0; i < ipc_capture_ctx.header.object_count; i++)
+    {
+        if (ipc_capture_ctx.handles[i] == object)
+            ipc_capture_ctx.handles[i] = RT_NULL;
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+/* 调用方已关中断 */
+static rt_int32_t ipc_capture_thread_index(rt_thread_t thread)
+{
+    struct ipc_capture_thread *desc;
+    rt_uint16_t i;
+
+    for (i = 0; i < ipc_capture_ctx.header.thread_count; i++)
+    {
+        if (ipc_capture_ctx.threads_handle[i] == thread)
+            return i;
+    }
+    if (i >= RTREPACK_IPC_CAPTURE_THREADS || i >= IPC_CAPTURE_THREAD_ISR)
+        return -1;
+
+    desc = &ipc_capture_ctx.threads[i];
+    rt_memset(desc, 0, sizeof(*desc));
+    rt_strncpy(desc->name, thread->name, IPC_CAPTURE_NAME_LEN);
+    desc->priority = repack_thread_cur_priority(thread);
+    ipc_capture_ctx.threads_handle[i] = thread;
+    ipc_capture_ctx.header.thread_count++;
+    return i;
+}
+
+static void ipc_capture_record(struct rt_object *object, rt_uint8_t op)
+{
+    struct ipc_capture_record *record;
+    rt_int32_t thread_index = IPC_CAPTURE_THREAD_ISR;
+    rt_uint32_t stamp;
+    rt_uint16_t i;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (!ipc_capture_ctx.running)
+        goto __exit;
+    for (i = 0; i < ipc_capture_ctx.header.object_count; i++)
+    {
+        if (ipc_capture_ctx.handles[i] == object)
+            break;
+    }
+    if (i == ipc_capture_ctx.header.object_count)
+        goto __exit;
+
+    if (rt_interrupt_get_nest() == 0)
+        thread_index = ipc_capture_thread_index(rt_thread_self());
+    if (thread_index < 0 || ipc_capture_ctx.header.record_count >= RTREPACK_IPC_CAPTURE_RECORDS)
+    {
+        ipc_capture_ctx.header.dropped++;
+        goto __exit;
+    }
+
+    record = &ipc_capture_ctx.records[ipc_capture_ctx.header.record_count];
+    stamp = repack_timestamp_get();
+    record->delta = ipc_capture_ctx.header.record_count++ ? stamp - ipc_capture_ctx.last_stamp : 0;
+    ipc_capture_ctx.last_stamp = stamp;
+    record->size = ipc_capture_ctx.objects[i].msg_size;
+    // 内核钩子不携带长度，发送方事先登记过实际长度时以登记值为准
+    if (op == IPC_CAPTURE_OP_PUT && ipc_capture_ctx.size_object == object &&
+        thread_index != IPC_CAPTURE_THREAD_ISR &&
+        ipc_capture_ctx.size_thread == rt_thread_self())
+    {
+        record->size = ipc_capture_ctx.size;
+        ipc_capture_ctx.size_object = RT_NULL;
+    }
+    record->object = (rt_uint8_t)i;
+    record->thread_op = (rt_uint8_t)((thread_index << 2) | op);
+
+__exit:
+    rt_hw_interrupt_enable(level);
+}
+
+static void ipc_capture_trytake_hook(struct rt_object *object)
+{
+    ipc_capture_record(object, IPC_CAPTURE_OP_TRYTAKE);
+}
+
+static void ipc_capture_take_hook(struct rt_object *object)
+{
+    ipc_capture_record(object, IPC_CAPTURE_OP_TAKE);
+}
+
+static void ipc_capture_put_hook(struct rt_object *object)
+{
+    ipc_capture_record(object, IPC_CAPTURE_OP_PUT);
+}
+
+/**
+ * @brief  发送消息并在记录中保存实际负载长度，参数与返回值同 `rt_mq_send_wait`。
+ *
+ * @note   内核的发送钩子只给出对象，直接调用 `rt_mq_send` 的记录只能按 `msg_size` 计长度；
+ *         需要按实际长度重放变长消息时改用本函数。不能在中断中调用。
+ */
+rt_err_t ipc_capture_mq_send(rt_mq_t mq, const void *buffer, rt_size_t size, rt_int32_t timeout)
+{
+    rt_base_t level;
+    rt_err_t ret;
+
+    level = rt_hw_interrupt_disable();
+    ipc_capture_ctx.size_object = &mq->parent.parent;
+    ipc_capture_ctx.size_thread = rt_thread_self();
+    ipc_capture_ctx.size = (rt_uint16_t)size;
+    rt_hw_interrupt_enable(level);
+    ret = rt_mq_send_wait(mq, buffer, size, timeout);
+    // 发送在钩子之前失败时登记值仍在，须清掉，否则会被本线程下一次普通发送取走
+    level = rt_hw_interrupt_disable();
+    if (ipc_capture_ctx.size_thread == rt_thread_self())
+        ipc_capture_ctx.size_object = RT_NULL;
+    rt_hw_interrupt_enable(level);
+    return ret;
+}
+
+/**
+ * @brief  开始记录。清空之前的记录，已登记的对象保持不变。
+ */
+void ipc_capture_start(void)
+{
+    rt_base_t level;
+
+    repack_timestamp_init();
+    level = rt_hw_interrupt_disable();
+    ipc_capture_ctx.header.magic = IPC_CAPTURE_MAGIC;
+    ipc_capture_ctx.header.version = IPC_CAPTURE_VERSION;
+    ipc_capture_ctx.header.record_size = sizeof(struct ipc_capture_record);
+    ipc_capture_ctx.header.timestamp_freq = repack_timestamp_freq();
+    ipc_capture_ctx.header.thread_count = 0;
+    ipc_capture_ctx.header.record_count = 0;
+    ipc_capture_ctx.header.dropped = 0;
+    ipc_capture_ctx.running = RT_TRUE;
+    rt_hw_interrupt_enable(level);
+
+    rt_object_trytake_sethook(ipc_capture_trytake_hook);
+    rt_object_take_sethook(ipc_capture_take_hook);
+    rt_object_put_sethook(ipc_capture_put_hook);
+}
+
+/**
+ * @brief  停止记录。记录缓冲区写满后会自动丢弃后续操作并计数，不会覆盖已有记录。
+ */
+void ipc_capture_stop(void)
+{
+    ipc_capture_ctx.running = RT_FALSE;
+    rt_object_trytake_sethook(RT_NULL);
+    rt_object_take_sethook(RT_NULL);
+    rt_object_put_sethook(RT_NULL);
+}
+
+#ifdef RT_USING_DFS
+#include <fcntl.h>
+#include <unistd.h>
+
+static rt_err_t ipc_capture_write(int fd, const void *buf, rt_size_t size)
+{
+    return (write(fd, buf, size) == (int)size) ? RT_EOK : -RT_EIO;
+}
+
+/**
+ * @brief  把当前记录保存为文件（应先调用 `ipc_capture_stop`）。
+ *
+ * @param[in] path  文件路径。
+ *
+ * @return `RT_EOK` 表示成功，`-RT_EIO` 表示文件读写失败。
+ */
+rt_err_t ipc_capture_save(const char *path)
+{
+    rt_err_t ret;
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0);
+
+    if (fd < 0)
+    {
+        LOG_E("ipc capture open %s failed...\n", path);
+        return -RT_EIO;
+    }
+    ret = ipc_capture_write(fd, &ipc_capture_ctx.header, sizeof(ipc_capture_ctx.header));
+    if (ret == RT_EOK)
+        ret = ipc_capture_write(fd, ipc_capture_ctx.objects,
+                                ipc_capture_ctx.header.object_count * sizeof(struct ipc_capture_object));
+    if (ret == RT_EOK)
+        ret = ipc_capture_write(fd, ipc_capture_ctx.threads,
+                                ipc_capture_ctx.header.thread_count * sizeof(struct ipc_capture_thread));
+    if (ret == RT_EOK)
+        ret = ipc_capture_write(fd, ipc_capture_ctx.records,
+                                ipc_capture_ctx.header.record_count * sizeof(struct ipc_capture_record));
+    close(fd);
+    if (ret != RT_EOK)
+    {
+        LOG_E("ipc capture write %s failed...\n", path);
+        return ret;
+    }
+    LOG_D("ipc capture saved %d records to %s\n", ipc_capture_ctx.header.record_count, path);
+    return RT_EOK;
+}
+#endif /* RT_USING_DFS */
+
+/* ---------------------------------- 重放 ---------------------------------- */
+/* 重放对象与线程全部动态创建，需要 RT_USING_HEAP */
+
+struct ipc_replay_config
+{
+    /* 返回重放时使用的对象类型（RT_Object_Class_xxx），为 RT_NULL 时按原类型重放 */
+    rt_uint8_t (*remap)(const struct ipc_capture_object *object);
+    rt_int32_t timeout;      /* 重放中每次阻塞操作的超时，避免记录不完整时死锁 */
+    rt_uint16_t speed;       /* 重放速度百分比，100 为原速，0 表示不等待间隔、尽快重放 */
+    rt_uint32_t stack_size;  /* 重放线程栈大小 */
+};
+
+struct ipc_replay_object_stat
+{
+    rt_uint32_t takes;
+    rt_uint32_t puts;
+    rt_uint32_t timeouts;
+    rt_uint32_t recorded_wait_max;  /* 微秒 */
+    rt_uint64_t recorded_wait_sum;  /* 微秒 */
+    rt_uint32_t replay_wait_max;    /* 微秒 */
+    rt_uint64_t replay_wait_sum;    /* 微秒 */
+};
+
+struct ipc_replay_result
+{
+    rt_uint32_t recorded_us;        /* 记录覆盖的时长 */
+    rt_uint32_t replay_us;          /* 重放实际耗时 */
+    rt_uint16_t object_count;
+    struct ipc_replay_object_stat objects[RTREPACK_IPC_CAPTURE_OBJECTS];
+};
+
+struct ipc_replay_state;
+
+struct ipc_replay_worker
+{
+    struct ipc_replay_state *state;
+    rt_thread_t thread;
+    rt_uint8_t index;
+    void *buffer;
+};
+
+struct ipc_replay_state
+{
+    const struct ipc_capture_header *header;
+    const struct ipc_capture_object *objects;
+    const struct ipc_capture_thread *threads;
+    const struct ipc_capture_record *records;
+    const struct ipc_replay_config *config;
+    struct ipc_replay_result *result;
+    rt_object_t handles[RTREPACK_IPC_CAPTURE_OBJECTS];
+    rt_uint8_t types[RTREPACK_IPC_CAPTURE_OBJECTS];
+    struct ipc_replay_worker workers[RTREPACK_IPC_CAPTURE_THREADS + 1];
+    struct rt_semaphore done;
+    rt_uint32_t start;
+    rt_uint32_t freq;
+};
+
+#ifdef RT_USING_HEAP
+static rt_err_t ipc_replay_create(struct ipc_replay_state *st, rt_uint16_t i)
+{
+    const struct ipc_capture_object *desc = &st->objects[i];
+    rt_uint8_t type = st->config->remap ? st->config->remap(desc) : desc->type;
+    rt_uint16_t capacity = desc->capacity ? desc->capacity : 16;
+    rt_uint16_t msg_size = desc->msg_size ? desc->msg_size : sizeof(rt_ubase_t);
+    char name[RT_NAME_MAX] = {0};
+    rt_err_t ret = -RT_EINVAL;
+
+    rt_strncpy(name, desc->name, (RT_NAME_MAX < IPC_CAPTURE_NAME_LEN) ? RT_NAME_MAX - 1 : IPC_CAPTURE_NAME_LEN);
+    switch (type)
+    {
+    case RT_Object_Class_Semaphore:
+        ret = semaphore_generator((rt_sem_t *)&st->handles[i], name, desc->type == type ? desc->capacity : 0,
+                                  RT_IPC_FLAG_PRIO, RT_TRUE);
+        break;
+    case RT_Object_Class_Mutex:
+        ret = mutex_generator((rt_mutex_t *)&st->handles[i], name, RT_IPC_FLAG_PRIO, RT_TRUE);
+        break;
+    case RT_Object_Class_Event:
+        ret = event_generator((rt_event_t *)&st->handles[i], name, RT_IPC_FLAG_PRIO, RT_TRUE);
+        break;
+    case RT_Object_Class_MailBox:
+        ret = mailbox_generator((rt_mailbox_t *)&st->handles[i], name, RT_NULL, capacity, RT_IPC_FLAG_PRIO, RT_TRUE);
+        break;
+    case RT_Object_Class_MessageQueue:
+        /* 动态创建时该参数直接交给 rt_mq_create，即消息条数 */
+        ret = messagequeue_generator((rt_mq_t *)&st->handles[i], name, RT_NULL, msg_size, capacity,
+                                     RT_IPC_FLAG_PRIO, RT_TRUE);
+        break;
+    }
+    st->types[i] = type;
+    return ret;
+}
+
+static void ipc_replay_destroy(struct ipc_replay_state *st, rt_uint16_t i)
+{
+    if (st->handles[i] == RT_NULL)
+        return;
+    switch (st->types[i])
+    {
+    case RT_Object_Class_Semaphore:    repack_sem_delete((rt_sem_t)st->handles[i]); break;
+    case RT_Object_Class_Mutex:        repack_mutex_delete((rt_mutex_t)st->handles[i]); break;
+    case RT_Object_Class_Event:        repack_event_delete((rt_event_t)st->handles[i]); break;
+    case RT_Object_Class_MailBox:      repack_mb_delete((rt_mailbox_t)st->handles[i]); break;
+    case RT_Object_Class_MessageQueue: repack_mq_delete((rt_mq_t)st->handles[i]); break;
+    }
+    st->handles[i] = RT_NULL;
+}
+
+static rt_err_t ipc_replay_op(struct ipc_replay_worker *w, rt_uint16_t i, rt_uint8_t op, rt_uint16_t size)
+{
+    struct ipc_replay_state *st = w->state;
+    rt_object_t object = st->handles[i];
+    rt_int32_t timeout = st->config->timeout;
+    rt_uint32_t set = 0;
+    rt_ubase_t value = 0;
+
+    if (op == IPC_CAPTURE_OP_PUT)
+    {
+        switch (st->types[i])
+        {
+        case RT_Object_Class_Semaphore:    return rt_sem_release((rt_sem_t)object);
+        case RT_Object_Class_Mutex:        return rt_mutex_release((rt_mutex_t)object);
+        case RT_Object_Class_Event:        return rt_event_send((rt_event_t)object, 0x01);
+        case RT_Object_Class_MailBox:      return rt_mb_send_wait((rt_mailbox_t)object, value, timeout);
+        case RT_Object_Class_MessageQueue:
+            if (size > ((rt_mq_t)object)->msg_size)
+                size = ((rt_mq_t)object)->msg_size;
+            return rt_mq_send_wait((rt_mq_t)object, w->buffer, size, timeout);
+        }
+    }
+    else
+    {
+        switch (st->types[i])
+        {
+        case RT_Object_Class_Semaphore:    return rt_sem_take((rt_sem_t)object, timeout);
+        case RT_Object_Class_Mutex:        return rt_mutex_take((rt_mutex_t)object, timeout);
+        case RT_Object_Class_Event:
+            return rt_event_recv((rt_event_t)object, 0xFFFFFFFF, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, timeout, &set);
+        case RT_Object_Class_MailBox:      return rt_mb_recv((rt_mailbox_t)object, &value, timeout);
+        case RT_Object_Class_MessageQueue:
+            return (rt_mq_recv((rt_mq_t)object, w->buffer, ((rt_mq_t)object)->msg_size, timeout) < 0) ? -RT_ETIMEOUT : RT_EOK;
+        }
+    }
+    return -RT_EINVAL;
+}
+
+/* 等待到重放时间轴上的目标时刻：整节拍部分睡眠，余下部分忙等（虚拟时间下直接消耗掉） */
+static void ipc_replay_wait_until(struct ipc_replay_state *st, rt_uint32_t target)
+{
+    rt_uint32_t per_tick = st->freq / RT_TICK_PER_SECOND;
+    rt_int32_t remain = (rt_int32_t)(target - repack_timestamp_get());
+
+    if (remain > (rt_int32_t)per_tick && per_tick != 0)
+        rt_thread_delay(remain / per_tick);
+#ifdef RTREPACK_USING_VIRTUAL_TIME
+    remain = (rt_int32_t)(target - repack_timestamp_get());
+    if (remain > 0)
+        vtime_consume((rt_uint32_t)((rt_uint64_t)remain * RTREPACK_VTIME_FREQ / st->freq) + 1);
+#else
+    while ((rt_int32_t)(target - repack_timestamp_get()) > 0)
+        ;
+#endif
+}
+
+/* 把记录时钟下的计数换算到频率 to 下，分两步相乘以免长记录溢出 64 位 */
+static rt_uint64_t ipc_replay_scale(rt_uint64_t count, rt_uint32_t to, rt_uint32_t from)
+{
+    return count / from * to + count % from * to / from;
+}
+
+static void ipc_replay_entry(void *parameter)
+{
+    struct ipc_replay_worker *w = (struct ipc_replay_worker *)parameter;
+    struct ipc_replay_state *st = w->state;
+    rt_uint64_t elapsed = 0;
+    rt_uint32_t i;
+
+    for (i = 0; i < st->header->record_count; i++)
+    {
+        const struct ipc_capture_record *record = &st->records[i];
+        struct ipc_replay_object_stat *stat = &st->result->objects[record->object];
+        rt_uint8_t op = record->thread_op & 0x03;
+        rt_uint32_t t0, wait_us;
+        rt_err_t ret;
+
+        elapsed += record->delta;
+        if ((record->thread_op >> 2) != w->index || op == IPC_CAPTURE_OP_TAKE ||
+            st->handles[record->object] == RT_NULL)
+            continue;
+
+        if (st->config->speed != 0)
+        {
+            rt_uint64_t offset = ipc_replay_scale(elapsed, st->freq, st->header->timestamp_freq) * 100 /
+                                 st->config->speed;
+            ipc_replay_wait_until(st, st->start + (rt_uint32_t)offset);
+        }
+
+        t0 = repack_timestamp_get();
+        ret = ipc_replay_op(w, record->object, op, record->size);
+        if (op == IPC_CAPTURE_OP_PUT)
+        {
+            stat->puts++;
+            continue;
+        }
+        wait_us = repack_timestamp_to_us(repack_timestamp_get() - t0, st->freq);
+        stat->takes++;
+        if (ret != RT_EOK)
+            stat->timeouts++;
+        stat->replay_wait_sum += wait_us;
+        if (wait_us > stat->replay_wait_max)
+            stat->replay_wait_max = wait_us;
+    }
+    rt_sem_release(&st->done);
+}
+
+/* 统计记录中每个对象的原始等待时间（同一线程的尝试获取到获取成功），返回记录覆盖的时长（微秒） */
+static rt_uint32_t ipc_replay_recorded_wait(struct ipc_replay_state *st)
+{
+    rt_uint64_t pending[IPC_CAPTURE_THREAD_ISR + 1];
+    rt_uint64_t elapsed = 0;
+    rt_uint32_t i;
+
+    rt_memset(pending, 0, sizeof(pending));
+    for (i = 0; i < st->header->record_count; i++)
+    {
+        const struct ipc_capture_record *record = &st->records[i];
+        struct ipc_replay_object_stat *stat = &st->result->objects[record->object];
+        rt_uint8_t thread = record->thread_op >> 2;
+        rt_uint32_t wait_us;
+
+        elapsed += record->delta;
+        if ((record->thread_op & 0x03) == IPC_CAPTURE_OP_TRYTAKE)
+        {
+            pending[thread] = elapsed;
+        }
+        else if ((record->thread_op & 0x03) == IPC_CAPTURE_OP_TAKE)
+        {
+            wait_us = (rt_uint32_t)ipc_replay_scale(elapsed - pending[thread], 1000000, st->header->timestamp_freq);
+            stat->recorded_wait_sum += wait_us;
+            if (wait_us > stat->recorded_wait_max)
+                stat->recorded_wait_max = wait_us;
+        }
+    }
+    return (rt_uint32_t)ipc_replay_scale(elapsed, 1000000, st->header->timestamp_freq);
+}
+
+/**
+ * @brief  重放一段记录。
+ *
+ * 为记录中的每个对象按原参数（或 `remap` 指定的替代类型）创建新对象，为每个记录线程
+ * 创建一个同优先级的重放线程（中断中的操作由一个最高优先级线程代为执行），按记录的
+ * 时间间隔重现获取与释放，结束后在 `result` 中给出每个对象原始与重放的等待时间。
+ *
+ * @param[in]  image   记录映像（`ipc_capture_save` 保存的文件内容）。
+ * @param[in]  size    映像字节数。
+ * @param[in]  config  重放配置。
+ * @param[out] result  重放结果。
+ *
+ * @return `RT_EOK` 表示成功，`-RT_EINVAL` 表示映像格式错误，`-ENOMEM` 表示内存不足。
+ */
+rt_err_t ipc_replay_run(const void *image, rt_size_t size,
+                        const struct ipc_replay_config *config,
+                        struct ipc_replay_result *result)
+{
+    const struct ipc_capture_header *header = (const struct ipc_capture_header *)image;
+    struct ipc_replay_state *st;
+    rt_uint16_t i, workers = 0;
+    rt_uint16_t max_msg = sizeof(rt_ubase_t);
+    rt_err_t ret = RT_EOK;
+
+    if (size < sizeof(*header) || header->magic != IPC_CAPTURE_MAGIC ||
+        header->version != IPC_CAPTURE_VERSION || header->timestamp_freq == 0 ||
+        header->record_size != sizeof(struct ipc_capture_record) ||
+        header->object_count > RTREPACK_IPC_CAPTURE_OBJECTS ||
+        header->thread_count > RTREPACK_IPC_CAPTURE_THREADS ||
+        size < sizeof(*header) + header->object_count * sizeof(struct ipc_capture_object) +
+                   header->thread_count * sizeof(struct ipc_capture_thread) +
+                   header->record_count * sizeof(struct ipc_capture_record))
+    {
+        LOG_E("ipc replay image invalid...\n");
+        return -RT_EINVAL;
+    }
+
+    st = (struct ipc_replay_state *)rt_calloc(1, sizeof(*st));
+    if (st == RT_NULL)
+        return -ENOMEM;
+    st->header = header;
+    st->objects = (const struct ipc_capture_object *)(header + 1);
+    st->threads = (const struct ipc_capture_thread *)(st->objects + header->object_count);
+    st->records = (const struct ipc_capture_record *)(st->threads + header->thread_count);
+    st->config = config;
+    st->result = result;
+    rt_memset(result, 0, sizeof(*result));
+    result->object_count = header->object_count;
+    repack_timestamp_init();
+    st->freq = repack_timestamp_freq();
+    rt_sem_init(&st->done, "replay", 0, RT_IPC_FLAG_FIFO);
+
+    // 重放对象不进入记录对象表，否则每次重放都会永久占用表项
+    ipc_capture_ctx.replaying = rt_thread_self();
+    for (i = 0; i < header->object_count && ret == RT_EOK; i++)
+    {
+        ret = ipc_replay_create(st, i);
+        if (st->objects[i].msg_size > max_msg)
+            max_msg = st->objects[i].msg_size;
+    }
+    ipc_capture_ctx.replaying = RT_NULL;
+
+    for (i = 0; i <= header->thread_count && ret == RT_EOK; i++)
+    {
+        struct ipc_replay_worker *w = &st->workers[workers];
+        const char *name = (i < header->thread_count) ? st->threads[i].name : "irq";
+        char thread_name[RT_NAME_MAX] = {0};
+
+        w->state = st;
+        w->index = (i < header->thread_count) ? i : IPC_CAPTURE_THREAD_ISR;
+        w->buffer = rt_calloc(1, max_msg);
+        if (w->buffer == RT_NULL)
+        {
+            ret = -ENOMEM;
+            break;
+        }
+        rt_snprintf(thread_name, sizeof(thread_name), "r%.*s", RT_NAME_MAX - 2, name);
+        ret = thread_generator(&w->thread, thread_name, ipc_replay_entry, w, RT_NULL,
+                               config->stack_size ? config->stack_size : 1024,
+                               (i < header->thread_count) ? st->threads[i].priority : 0, 10, RT_TRUE);
+        if (ret != RT_EOK)
+        {
+            rt_free(w->buffer);
+            break;
+        }
+        workers++;
+    }
+
+    if (ret == RT_EOK)
+    {
+        result->recorded_us = ipc_replay_recorded_wait(st);
+        st->start = repack_timestamp_get();
+        for (i = 0; i < workers; i++)
+            rt_thread_startup(st->workers[i].thread);
+        for (i = 0; i < workers; i++)
+            rt_sem_take(&st->done, RT_WAITING_FOREVER);
+        result->replay_us = repack_timestamp_to_us(repack_timestamp_get() - st->start, st->freq);
+    }
+    else
+    {
+        LOG_E("ipc replay setup failed...\n");
+        for (i = 0; i < workers; i++)
+            repack_thread_delete(st->workers[i].thread);
+    }
+
+    for (i = 0; i < workers; i++)
+        rt_free(st->workers[i].buffer);
+    for (i = 0; i < header->object_count; i++)
+        ipc_replay_destroy(st, i);
+    rt_sem_detach(&st->done);
+    rt_free(st);
+    return ret;
+}
+
+#ifdef RT_USING_DFS
+/**
+ * @brief  从文件读取记录并重放，参数与返回值同 `ipc_replay_run`。
+ */
+rt_err_t ipc_replay_file(const char *path,
+                         const struct ipc_replay_config *config,
+                         struct ipc_replay_result *result)
+{
+    rt_err_t ret;
+    void *image;
+    int fd, size;
+
+    fd = open(path, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        LOG_E("ipc replay open %s failed...\n", path);
+        return -RT_EIO;
+    }
+    size = lseek(fd, 0, SEEK_END);
+    lseek(fd, 0, SEEK_SET);
+    image = (size > 0) ? rt_malloc(size) : RT_NULL;
+    if (image == RT_NULL)
+    {
+        close(fd);
+        return -ENOMEM;
+    }
+    ret = (read(fd, image, size) == size) ? ipc_replay_run(image, size, config, result) : -RT_EIO;
+    close(fd);
+    rt_free(image);
+    return ret;
+}
+#endif /* RT_USING_DFS */
+#endif /* RT_USING_HEAP */
+
+/**
+ * @brief  打印重放结果。
+ */
+void ipc_replay_report(const struct ipc_replay_result *result)
+{
+    rt_uint16_t i;
+
+    rt_kprintf("recorded %d us, replayed %d us\n", result->recorded_us, result->replay_us);
+    rt_kprintf("obj takes    puts     tmo   rec_avg  rec_max  rep_avg  rep_max (us)\n");
+    for (i = 0; i < result->object_count; i++)
+    {
+        const struct ipc_replay_object_stat *stat = &result->objects[i];
+        rt_uint32_t n = stat->takes ? stat->takes : 1;
+
+        rt_kprintf("%-3d %-8d %-8d %-5d %-8d %-8d %-8d %-8d\n", i, stat->takes, stat->puts, stat->timeouts,
+                   (rt_uint32_t)(stat->recorded_wait_sum / n), stat->recorded_wait_max,
+                   (rt_uint32_t)(stat->replay_wait_sum / n), stat->replay_wait_max);
+    }
+}
+
+#ifdef RT_USING_FINSH
+static int ipc_capture(int argc, char **argv)
+{
+    if (argc >= 2 && !rt_strncmp(argv[1], "start", 5))
+        ipc_capture_start();
+    else if (argc >= 2 && !rt_strncmp(argv[1], "stop", 4))
+        ipc_capture_stop();
+#ifdef RT_USING_DFS
+    else if (argc >= 3 && !rt_strncmp(argv[1], "save", 4))
+        return ipc_capture_save(argv[2]);
+#endif
+    else
+        rt_kprintf("usage: ipc_capture start|stop|save <path>\n");
+    rt_kprintf("objects %d, threads %d, records %d, dropped %d\n", ipc_capture_ctx.header.object_count,
+               ipc_capture_ctx.header.thread_count, ipc_capture_ctx.header.record_count, ipc_capture_ctx.header.dropped);
+    return 0;
+}
+MSH_CMD_EXPORT(ipc_capture, record IPC traffic of library objects);
+#endif /* RT_USING_FINSH */
+#endif /* RTREPACK_USING_IPC_CAPTURE */
+
+#ifdef RTREPACK_USING_VIRTUAL_TIME
+/*
+ * 确定性虚拟时间（用于 Linux 托管的模拟器 BSP）。
+ *
+ * 系统节拍不再由宿主定时器驱动，而由虚拟时钟推进：
+ *   - 线程通过 `vtime_consume` 声明自己消耗的 CPU 时间，跨过节拍边界时按内核
+ *     `rt_tick_increase` 的规则扣减时间片并检查定时器；
+ *   - 所有线程都阻塞在库对象上、空闲线程运行时，虚拟时钟直接跳到下一个定时器到期点。
+ * 优先级抢占、时间片轮转与超时仍由内核原样完成，只是时间来源不再受宿主调度干扰，
+ * 因此同一输入的延迟实验逐位可复现，且空闲时间不占用真实时间。
+ *
+ * 虚拟时钟只有上述两种推进方式：阻塞本身不消耗虚拟时间，只要还有线程就绪、空闲线程
+ * 得不到运行，时钟就停在原处；忙等时间戳的循环必须改为 `vtime_consume`，否则永远等不到。
+ *
+ * 使用时 BSP 的节拍中断须改为调用 `vtime_hw_tick`，该函数在虚拟时间运行期间不做任何事；
+ * 否则宿主节拍会继续推进系统节拍而虚拟时钟不动，两者失去对应关系。
+ * 节拍推进时模拟一次节拍中断（关中断、`rt_interrupt_enter` 后调用 `rt_tick_increase`），
+ * 要求移植层的 `rt_hw_context_switch_interrupt` 在开中断后完成挂起的切换，
+ * Cortex-M 的 PendSV 与模拟器 BSP 均满足。
+ */
+#define VTIME_PER_TICK ((rt_uint64_t)(RTREPACK_VTIME_FREQ / RT_TICK_PER_SECOND))
+
+static struct
+{
+    rt_bool_t running;
+    rt_bool_t quiescent;
+    void (*on_quiescent)(void);
+} vtime_ctx;
+
+/* 节拍前进一格：模拟一次节拍中断，时间片记账与定时器检查都交给 rt_tick_increase */
+static void vtime_tick_step(void)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    rt_interrupt_enter();
+    rt_tick_increase();
+    rt_interrupt_leave();
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * @brief  当前线程消耗一段虚拟 CPU 时间，用于为计算开销建模。
+ *
+ * @param[in] duration  消耗的时间，单位为 1/RTREPACK_VTIME_FREQ 秒。
+ *
+ * @note  只能在线程中调用。跨过节拍边界时可能因时间片用完或定时器唤醒更高优先级线程而被切换。
+ */
+void vtime_consume(rt_uint32_t duration)
+{
+    while (duration > 0)
+    {
+        rt_uint64_t to_tick = VTIME_PER_TICK - (vtime_now % VTIME_PER_TICK);
+
+        if (duration < to_tick)
+        {
+            vtime_now += duration;
+            break;
+        }
+        vtime_now += to_tick;
+        duration -= (rt_uint32_t)to_tick;
+        vtime_tick_step();
+    }
+}
+
+/* 空闲钩子：所有线程阻塞时把虚拟时钟跳到下一个定时器到期点 */
+static void vtime_idle_hook(void)
+{
+    rt_tick_t now, next;
+    rt_base_t level;
+
+    if (!vtime_ctx.running)
+        return;
+
+    next = rt_timer_next_timeout_tick();
+    if (next == RT_TICK_MAX)
+    {
+        /* 没有任何定时器，系统已无法再前进 */
+        if (!vtime_ctx.quiescent)
+        {
+            vtime_ctx.quiescent = RT_TRUE;
+            if (vtime_ctx.on_quiescent)
+                vtime_ctx.on_quiescent();
+        }
+        return;
+    }
+    vtime_ctx.quiescent = RT_FALSE;
+
+    level = rt_hw_interrupt_disable();
+    now = rt_tick_get();
+    if ((rt_int32_t)(next - now) > 0)
+    {
+        // 跳到到期点的前一拍，最后一拍走正常的节拍路径完成定时器检查
+        vtime_now = (vtime_now / VTIME_PER_TICK + (next - now)) * VTIME_PER_TICK;
+        rt_tick_set(next - 1);
+    }
+    rt_hw_interrupt_enable(level);
+    vtime_tick_step();
+}
+
+/**
+ * @brief  切换到虚拟时间。
+ *
+ * @param[in] on_quiescent  所有线程永久阻塞且无定时器时的回调（在空闲线程中调用一次），
+ *                          通常用于输出实验结果并退出宿主进程，可为 `RT_NULL`。
+ *
+ * @return `RT_EOK` 表示成功，其他值为设置空闲钩子失败。
+ */
+rt_err_t vtime_start(void (*on_quiescent)(void))
+{
+    rt_err_t ret;
+
+    vtime_now = (rt_uint64_t)rt_tick_get() * VTIME_PER_TICK;
+    vtime_ctx.on_quiescent = on_quiescent;
+    vtime_ctx.quiescent = RT_FALSE;
+    ret = rt_thread_idle_sethook(vtime_idle_hook);
+    if (ret != RT_EOK)
+    {
+        LOG_E("vtime rt_thread_idle_sethook failed...\n");
+        return ret;
+    }
+    vtime_ctx.running = RT_TRUE;
+    LOG_D("vtime started...\n");
+    return RT_EOK;
+}
+
+/**
+ * @brief  回到宿主定时器驱动的真实时间。
+ */
+void vtime_stop(void)
+{
+    vtime_ctx.running = RT_FALSE;
+    rt_thread_idle_delhook(vtime_idle_hook);
+}
+
+/**
+ * @brief  当前虚拟时间（单位 1/RTREPACK_VTIME_FREQ 秒）。
+ */
+rt_inline rt_uint64_t vtime_get(void)
+{
+    return vtime_now;
+}
+
+/**
+ * @brief  供 BSP 节拍中断调用，替代 `rt_tick_increase`。虚拟时间运行期间忽略宿主节拍。
+ */
+void vtime_hw_tick(void)
+{
+    if (!vtime_ctx.running)
+        rt_tick_increase();
+}
+#endif /* RTREPACK_USING_VIRTUAL_TIME */
+
+#ifdef RTREPACK_USING_BENCH
+/*
+ * 竞争扩展性扫描：对生成器能创建的每种 IPC 原语，在不同的生产者数、消费者数与核数下
+ * 各运行一段时间，统计吞吐与延迟分布，结果以 CSV 行输出，可由 tools/bench_plot.py 绘图。
+ *
+ * 延迟口径：邮箱与消息队列为发送到接收的端到端延迟；信号量与事件集为消费者一次获取
+ * （含阻塞）的耗时；互斥量不区分生产者与消费者，所有线程都做加锁/解锁，延迟为加锁耗时。
+ */
+#define BENCH_KIND_SEM      (1 << 0)
+#define BENCH_KIND_MUTEX    (1 << 1)
+#define BENCH_KIND_EVENT    (1 << 2)
+#define BENCH_KIND_MAILBOX  (1 << 3)
+#define BENCH_KIND_MQ       (1 << 4)
+#define BENCH_KIND_ALL      0x1F
+
+#define BENCH_MAX_THREADS   16
+#define BENCH_QUEUE_DEPTH   32
+
+struct bench_sweep_config
+{
+    rt_uint32_t kinds;          /* BENCH_KIND_xxx 的组合 */
+    rt_uint8_t max_producers;   /* 生产者数按 1、2、4、8、16 扫描，不超过该值 */
+    rt_uint8_t max_consumers;   /* 消费者数同上 */
+    rt_uint8_t max_cpus;        /* 核数从 1 扫描到该值（非 SMP 时固定为 1） */
+    rt_uint8_t priority;        /* 测试线程优先级，应低于控制线程 */
+    rt_uint32_t duration;       /* 每个测点的运行时长（tick） */
+};
+
+struct bench_point;
+
+struct bench_worker
+{
+    struct bench_point *point;
+    rt_thread_t thread;
+    rt_bool_t producer;
+    rt_uint32_t ops;
+    struct repack_hist hist;    /* 时间戳计数单位 */
+};
+
+struct bench_point
+{
+    rt_uint32_t kind;
+    rt_object_t object;
+    volatile rt_bool_t stop;
+    struct rt_semaphore done;
+    struct bench_worker workers[BENCH_MAX_THREADS * 2];
+};
+
+struct bench_msg
+{
+    rt_uint32_t stamp;
+    rt_uint32_t payload[3];
+};
+
+static const char *bench_kind_name(rt_uint32_t kind)
+{
+    switch (kind)
+    {
+    case BENCH_KIND_SEM:     return "sem";
+    case BENCH_KIND_MUTEX:   return "mutex";
+    case BENCH_KIND_EVENT:   return "event";
+    case BENCH_KIND_MAILBOX: return "mailbox";
+    case BENCH_KIND_MQ:      return "mq";
+    }
+    return "?";
+}
+
+static void bench_produce(struct bench_worker *w)
+{
+    struct bench_point *pt = w->point;
+    struct bench_msg msg = {0};
+
+    switch (pt->kind)
+    {
+    case BENCH_KIND_SEM:
+        /* 信号量没有容量上限，积压过多时让出 CPU，避免计数溢出 */
+        if (((rt_sem_t)pt->object)->value >= BENCH_QUEUE_DEPTH)
+        {
+            rt_thread_yield();
+            return;
+        }
+        rt_sem_release((rt_sem_t)pt->object);
+        break;
+    case BENCH_KIND_EVENT:
+        rt_event_send((rt_event_t)pt->object, 1UL << (w - pt->workers) % 32);
+        rt_thread_yield();
+        break;
+    case BENCH_KIND_MAILBOX:
+        if (rt_mb_send_wait((rt_mailbox_t)pt->object, repack_timestamp_get(), 1) != RT_EOK)
+            return;
+        break;
+    case BENCH_KIND_MQ:
+        msg.stamp = repack_timestamp_get();
+        if (rt_mq_send_wait((rt_mq_t)pt->object, &msg, sizeof(msg), 1) != RT_EOK)
+            return;
+        break;
+    }
+    w->ops++;
+}
+
+static void bench_consume(struct bench_worker *w)
+{
+    struct bench_point *pt = w->point;
+    rt_uint32_t t0 = repack_timestamp_get();
+    struct bench_msg msg;
+    rt_ubase_t value;
+    rt_uint32_t set;
+
+    switch (pt->kind)
+    {
+    case BENCH_KIND_SEM:
+        if (rt_sem_take((rt_sem_t)pt->object, 1) != RT_EOK)
+            return;
+        break;
+    case BENCH_KIND_MUTEX:
+        if (rt_mutex_take((rt_mutex_t)pt->object, 1) != RT_EOK)
+            return;
+        repack_hist_add(&w->hist, repack_timestamp_get() - t0);
+        rt_mutex_release((rt_mutex_t)pt->object);
+        w->ops++;
+        return;
+    case BENCH_KIND_EVENT:
+        if (rt_event_recv((rt_event_t)pt->object, 0xFFFFFFFF, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, 1, &set) != RT_EOK)
+            return;
+        break;
+    case BENCH_KIND_MAILBOX:
+        if (rt_mb_recv((rt_mailbox_t)pt->object, &value, 1) != RT_EOK)
+            return;
+        t0 = (rt_uint32_t)value;
+        break;
+    case BENCH_KIND_MQ:
+        if (rt_mq_recv((rt_mq_t)pt->object, &msg, sizeof(msg), 1) < 0)
+            return;
+        t0 = msg.stamp;
+        break;
+    }
+    repack_hist_add(&w->hist, repack_timestamp_get() - t0);
+    w->ops++;
+}
+
+static void bench_worker_entry(void *parameter)
+{
+    struct bench_worker *w = (struct bench_worker *)parameter;
+
+    while (!w->point->stop)
+    {
+        if (w->producer && w->point->kind != BENCH_KIND_MUTEX)
+            bench_produce(w);
+        else
+            bench_consume(w);
+#ifdef RTREPACK_USING_VIRTUAL_TIME
+        /* 每次操作计一个虚拟时间单位，否则工作线程始终就绪、时钟不动，测点永远不会结束 */
+        vtime_consume(1);
+#endif
+    }
+    rt_sem_release(&w->point->done);
+}
+
+static rt_err_t bench_object_create(struct bench_point *pt)
+{
+    switch (pt->kind)
+    {
+    case BENCH_KIND_SEM:
+        return semaphore_generator((rt_sem_t *)&pt->object, "bsem", 0, RT_IPC_FLAG_PRIO, RT_TRUE);
+    case BENCH_KIND_MUTEX:
+        return mutex_generator((rt_mutex_t *)&pt->object, "bmtx", RT_IPC_FLAG_PRIO, RT_TRUE);
+    case BENCH_KIND_EVENT:
+        return event_generator((rt_event_t *)&pt->object, "bevt", RT_IPC_FLAG_PRIO, RT_TRUE);
+    case BENCH_KIND_MAILBOX:
+        return mailbox_generator((rt_mailbox_t *)&pt->object, "bmb", RT_NULL, BENCH_QUEUE_DEPTH, RT_IPC_FLAG_PRIO, RT_TRUE);
+    case BENCH_KIND_MQ:
+        /* 动态创建时该参数直接交给 rt_mq_create，即消息条数 */
+        return messagequeue_generator((rt_mq_t *)&pt->object, "bmq", RT_NULL, sizeof(struct bench_msg),
+                                      BENCH_QUEUE_DEPTH, RT_IPC_FLAG_PRIO, RT_TRUE);
+    }
+    return -RT_EINVAL;
+}
+
+static void bench_object_delete(struct bench_point *pt)
+{
+    switch (pt->kind)
+    {
+    case BENCH_KIND_SEM:     repack_sem_delete((rt_sem_t)pt->object); break;
+    case BENCH_KIND_MUTEX:   repack_mutex_delete((rt_mutex_t)pt->object); break;
+    case BENCH_KIND_EVENT:   repack_event_delete((rt_event_t)pt->object); break;
+    case BENCH_KIND_MAILBOX: repack_mb_delete((rt_mailbox_t)pt->object); break;
+    case BENCH_KIND_MQ:      repack_mq_delete((rt_mq_t)pt->object); break;
+    }
+}
+
+/* 运行一个测点并输出一行 CSV */
+static rt_err_t bench_run_point(const struct bench_sweep_config *config, rt_uint32_t kind,
+                                rt_uint8_t cpus, rt_uint8_t producers, rt_uint8_t consumers)
+{
+    struct bench_point *pt;
+    struct repack_hist hist;
+    rt_uint32_t ops = 0, freq = repack_timestamp_freq();
+    rt_uint8_t i, started = 0, total = producers + consumers;
+    rt_tick_t t0, elapsed;
+    rt_err_t ret;
+
+    pt = (struct bench_point *)rt_calloc(1, sizeof(*pt));
+    if (pt == RT_NULL)
+        return -ENOMEM;
+    pt->kind = kind;
+    rt_sem_init(&pt->done, "bdone", 0, RT_IPC_FLAG_FIFO);
+    ret = bench_object_create(pt);
+
+    for (i = 0; i < total && ret == RT_EOK; i++)
+    {
+        struct bench_worker *w = &pt->workers[i];
+        char name[RT_NAME_MAX];
+
+        w->point = pt;
+        w->producer = (i < producers);
+        rt_snprintf(name, sizeof(name), "b%c%d", w->producer ? 'p' : 'c', i);
+        ret = thread_generator(&w->thread, name, bench_worker_entry, w, RT_NULL,
+                               RTREPACK_BENCH_STACK_SIZE, config->priority, 10, RT_TRUE);
+#ifdef RT_USING_SMP
+        if (ret == RT_EOK)
+            rt_thread_control(w->thread, RT_THREAD_CTRL_BIND_CPU, (void *)(rt_ubase_t)(i % cpus));
+#endif
+    }
+
+    if (ret == RT_EOK)
+    {
+        t0 = rt_tick_get();
+        for (i = 0; i < total; i++, started++)
+            rt_thread_startup(pt->workers[i].thread);
+        rt_thread_delay(config->duration);
+        pt->stop = RT_TRUE;
+        for (i = 0; i < started; i++)
+            rt_sem_take(&pt->done, RT_WAITING_FOREVER);
+        elapsed = rt_tick_get() - t0;
+
+        rt_memset(&hist, 0, sizeof(hist));
+        for (i = producers; i < total; i++)
+        {
+            repack_hist_merge(&hist, &pt->workers[i].hist);
+            ops += pt->workers[i].ops;
+        }
+        if (kind == BENCH_KIND_MUTEX)
+        {
+            for (i = 0; i < producers; i++)
+            {
+                repack_hist_merge(&hist, &pt->workers[i].hist);
+                ops += pt->workers[i].ops;
+            }
+        }
+        rt_kprintf("bench,%s,%d,%d,%d,%d,%d,%d,%d\n", bench_kind_name(kind), cpus, producers, consumers,
+                   (rt_uint32_t)((rt_uint64_t)ops * RT_TICK_PER_SECOND / (elapsed ? elapsed : 1)),
+                   repack_timestamp_to_us(repack_hist_percentile(&hist, 500), freq),
+                   repack_timestamp_to_us(repack_hist_percentile(&hist, 990), freq),
+                   repack_timestamp_to_us(hist.max, freq));
+    }
+    else
+    {
+        LOG_E("bench point %s %d/%d setup failed...\n", bench_kind_name(kind), producers, consumers);
+        for (i = 0; i < total; i++)
+        {
+            if (pt->workers[i].thread != RT_NULL)
+                repack_thread_delete(pt->workers[i].thread);
+        }
+    }
+
+    if (pt->object != RT_NULL)
+        bench_object_delete(pt);
+    rt_sem_detach(&pt->done);
+    rt_free(pt);
+    return ret;
+}
+
+/**
+ * @brief  填入默认扫描配置：全部原语、1~16 个生产者/消费者、全部核，每个测点 100ms。
+ */
+void bench_sweep_config_default(struct bench_sweep_config *config)
+{
+    config->kinds = BENCH_KIND_ALL;
+    config->max_producers = BENCH_MAX_THREADS;
+    config->max_consumers = BENCH_MAX_THREADS;
+    config->max_cpus = RTREPACK_CPUS_NR;
+    config->priority = RT_THREAD_PRIORITY_MAX - 2;
+    config->duration = RT_TICK_PER_SECOND / 10;
+}
+
+/**
+ * @brief  竞争扩展性扫描。
+ *
+ * 每个测点输出一行：`bench,<kind>,<cpus>,<producers>,<consumers>,<ops/s>,<p50_us>,<p99_us>,<max_us>`。
+ *
+ * @param[in] config  扫描配置，为 `RT_NULL` 时使用 `bench_sweep_config_default` 的配置。
+ *
+ * @return `RT_EOK` 表示全部测点完成，其他值为首个失败测点的错误码。
+ *
+ * @note  应从优先级高于测试线程的线程中调用；测试期间会动态创建对象与线程。
+ */
+rt_err_t bench_contention_sweep(const struct bench_sweep_config *config)
+{
+    struct bench_sweep_config def;
+    rt_uint32_t kind;
+    rt_uint8_t cpus, p, c;
+    rt_err_t ret;
+
+    if (config == RT_NULL)
+    {
+        bench_sweep_config_default(&def);
+        config = &def;
+    }
+    repack_timestamp_init();
+    rt_kprintf("bench,kind,cpus,producers,consumers,ops_per_sec,p50_us,p99_us,max_us\n");
+    for (kind = 1; kind <= BENCH_KIND_MQ; kind <<= 1)
+    {
+        if (!(config->kinds & kind))
+            continue;
+        for (cpus = 1; cpus <= config->max_cpus; cpus++)
+        {
+            for (p = 1; p <= config->max_producers && p <= BENCH_MAX_THREADS; p <<= 1)
+            {
+                for (c = 1; c <= config->max_consumers && c <= BENCH_MAX_THREADS; c <<= 1)
+                {
+                    ret = bench_run_point(config, kind, cpus, p, c);
+                    if (ret != RT_EOK)
+                        return ret;
+                }
+            }
+        }
+    }
+    return RT_EOK;
+}
+
+/*
+ * 微基准：单线程内反复执行一段操作序列，每轮用时间戳计时，输出一行
+ * `micro,<case>,<rounds>,<avg_ns>,<p50_ns>,<p99_ns>,<max_ns>`，用于对比同一用途的不同原语。
+ */
+static rt_uint32_t bench_ns(rt_uint64_t delta, rt_uint32_t freq)
+{
+    return (rt_uint32_t)(delta * 1000000000ULL / freq);
+}
+
+static void bench_micro_report(const char *name, rt_uint32_t rounds, const struct repack_hist *hist)
+{
+    rt_uint32_t freq = repack_timestamp_freq();
+
+    rt_kprintf("micro,%s,%d,%d,%d,%d,%d\n", name, rounds,
+               bench_ns(hist->count ? hist->sum / hist->count : 0, freq),
+               bench_ns(repack_hist_percentile(hist, 500), freq),
+               bench_ns(repack_hist_percentile(hist, 990), freq),
+               bench_ns(hist->max, freq));
+}
+
+/* 完成信号量：缓存借出/释放/等待/归还，对比每次请求 创建/释放/等待/删除 */
+static rt_err_t bench_micro_sem_cache(rt_uint32_t rounds)
+{
+    struct repack_hist hist;
+    sem_cache_t cache = RT_NULL;
+    rt_sem_t sem = RT_NULL;
+    rt_uint32_t i, t0;
+    rt_err_t ret;
+
+    ret = sem_cache_generator(&cache, "bsc", RT_NULL, 4, RT_IPC_FLAG_FIFO, RT_TRUE);
+    if (ret != RT_EOK)
+        return ret;
+    rt_memset(&hist, 0, sizeof(hist));
+    for (i = 0; i < rounds; i++)
+    {
+        t0 = repack_timestamp_get();
+        sem = sem_cache_borrow(cache);
+        rt_sem_release(sem);
+        rt_sem_take(sem, RT_WAITING_FOREVER);
+        sem_cache_return(cache, sem);
+        repack_hist_add(&hist, repack_timestamp_get() - t0);
+    }
+    bench_micro_report("sem_cache", rounds, &hist);
+    sem_cache_delete(cache);
+
+    rt_memset(&hist, 0, sizeof(hist));
+    for (i = 0; i < rounds; i++)
+    {
+        t0 = repack_timestamp_get();
+        ret = semaphore_generator(&sem, "bsc", 0, RT_IPC_FLAG_FIFO, RT_TRUE);
+        if (ret != RT_EOK)
+            return ret;
+        rt_sem_release(sem);
+        rt_sem_take(sem, RT_WAITING_FOREVER);
+        repack_sem_delete(sem);
+        repack_hist_add(&hist, repack_timestamp_get() - t0);
+    }
+    bench_micro_report("sem_create", rounds, &hist);
+    return RT_EOK;
+}
+
+/* 无竞争加锁/解锁：rt_mutex 对比轻量互斥量与优先级天花板互斥量 */
+static rt_err_t bench_micro_mutex(rt_uint32_t rounds)
+{
+    struct repack_hist hist;
+    rt_mutex_t mutex = RT_NULL;
+    lite_mutex_t lite = RT_NULL;
+    ceiling_mutex_t ceiling = RT_NULL;
+    rt_uint32_t i, t0;
+    rt_err_t ret;
+
+    ret = mutex_generator(&mutex, "bmtx", RT_IPC_FLAG_PRIO, RT_TRUE);
+    if (ret != RT_EOK)
+        return ret;
+    rt_memset(&hist, 0, sizeof(hist));
+    for (i = 0; i < rounds; i++)
+    {
+        t0 = repack_timestamp_get();
+        rt_mutex_take(mutex, RT_WAITING_FOREVER);
+        rt_mutex_release(mutex);
+        repack_hist_add(&hist, repack_timestamp_get() - t0);
+    }
+    bench_micro_report("rt_mutex", rounds, &hist);
+    repack_mutex_delete(mutex);
+
+    ret = lite_mutex_generator(&lite, "blite", RT_TRUE);
+    if (ret != RT_EOK)
+        return ret;
+    rt_memset(&hist, 0, sizeof(hist));
+    for (i = 0; i < rounds; i++)
+    {
+        t0 = repack_timestamp_get();
+        lite_mutex_take(lite, RT_WAITING_FOREVER);
+        lite_mutex_release(lite);
+        repack_hist_add(&hist, repack_timestamp_get() - t0);
+    }
+    bench_micro_report("lite_mutex", rounds, &hist);
+    lite_mutex_delete(lite);
+
+    ret = ceiling_mutex_generator(&ceiling, "bceil", repack_thread_cur_priority(rt_thread_self()), RT_TRUE);
+    if (ret != RT_EOK)
+        return ret;
+    rt_memset(&hist, 0, sizeof(hist));
+    for (i = 0; i < rounds; i++)
+    {
+        t0 = repack_timestamp_get();
+        ceiling_mutex_take(ceiling, RT_WAITING_FOREVER);
+        ceiling_mutex_release(ceiling);
+        repack_hist_add(&hist, repack_timestamp_get() - t0);
+    }
+    bench_micro_report("ceiling_mutex", rounds, &hist);
+    ceiling_mutex_delete(ceiling);
+    return RT_EOK;
+}
+
+/**
+ * @brief  依次运行全部微基准。
+ *
+ * @param[in] rounds  每项的轮数。
+ *
+ * @return `RT_EOK` 表示全部完成，其他值为首个失败项的错误码。
+ */
+rt_err_t bench_micro(rt_uint32_t rounds)
+{
+    rt_err_t ret;
+
+    repack_timestamp_init();
+    rt_kprintf("micro,case,rounds,avg_ns,p50_ns,p99_ns,max_ns\n");
+    ret = bench_micro_sem_cache(rounds);
+    if (ret == RT_EOK)
+        ret = bench_micro_mutex(rounds);
+    return ret;
+}
+
+#ifdef RT_USING_FINSH
+#include <stdlib.h>
+
+static int bench_sweep(int argc, char **argv)
+{
+    struct bench_sweep_config config;
+
+    bench_sweep_config_default(&config);
+    if (argc >= 2)
+        config.duration = rt_tick_from_millisecond(atoi(argv[1]));
+    return bench_contention_sweep(&config);
+}
+MSH_CMD_EXPORT(bench_sweep, IPC contention scaling sweep [duration_ms]);
+
+static int bench_micro_cmd(int argc, char **argv)
+{
+    return bench_micro((argc >= 2) ? atoi(argv[1]) : 10000);
+}
+MSH_CMD_EXPORT_ALIAS(bench_micro_cmd, bench_micro, primitive micro benchmarks [rounds]);
+#endif /* RT_USING_FINSH */
+#endif /* RTREPACK_USING_BENCH */
+
+#if defined(GET_PIN) && defined(GPIOA_BASE)
+/*
+ * 端口级批量 GPIO（STM32 drv_gpio）。
+ *
+ * `GET_PIN(PORTx, n)` 的编号为 `端口序号 * 16 + n`，各端口寄存器组间隔 0x400，
+ * 因此引脚到端口与位掩码的换算可在编译期（常量引脚）或初始化时完成，
+ * 之后同一端口上任意多个引脚的置位/清零只需一次 BSRR 写入，读取只需一次 IDR 读取，
+ * 省去 `rt_pin_write` 每个引脚一次的查表与函数指针调用。
+ */
+#define GPIO_PIN_PORT(pin)   ((GPIO_TypeDef *)(GPIOA_BASE + ((rt_ubase_t)(pin) >> 4) * 0x0400UL))
+#define GPIO_PIN_MASK(pin)   ((rt_uint16_t)(1U << ((rt_ubase_t)(pin) & 0x0F)))
+
+/**
+ * @brief  一次写入同一端口上的多个引脚。
+ *
+ * @param[in] port        端口寄存器组，可由 `GPIO_PIN_PORT(pin)` 得到。
+ * @param[in] set_mask    需置高的引脚掩码。
+ * @param[in] clear_mask  需置低的引脚掩码（与 `set_mask` 重叠时置高优先）。
+ */
+rt_inline void gpio_port_write(GPIO_TypeDef *port, rt_uint16_t set_mask, rt_uint16_t clear_mask)
+{
+    port->BSRR = (rt_uint32_t)set_mask | ((rt_uint32_t)clear_mask << 16);
+}
+
+/**
+ * @brief  一次读取整个端口的输入电平。
+ */
+rt_inline rt_uint16_t gpio_port_read(GPIO_TypeDef *port)
+{
+    return (rt_uint16_t)port->IDR;
+}
+
+/**
+ * @brief  翻转同一端口上的多个引脚（基于输出寄存器当前值，一次 BSRR 写入完成）。
+ */
+rt_inline void gpio_port_toggle(GPIO_TypeDef *port, rt_uint16_t mask)
+{
+    rt_uint16_t odr = (rt_uint16_t)port->ODR;
+
+    port->BSRR = (rt_uint32_t)(~odr & mask) | ((rt_uint32_t)(odr & mask) << 16);
+}
+
+/*
+ * 并行总线：把同一端口上任意排列的若干引脚视为一个整数的各个数据位。
+ * 初始化时生成按半字节查表的映射，写入为 4 次查表 + 1 次 BSRR 写；
+ * 引脚连续升序时退化为一次移位。
+ */
+struct gpio_bus
+{
+    GPIO_TypeDef *port;
+    rt_uint16_t mask;          /* 总线占用的全部引脚 */
+    rt_uint8_t width;          /* 数据位数，不超过 16 */
+    rt_uint8_t shift;          /* 引脚连续升序时数据位 0 的位置，否则为 0xFF */
+    rt_uint16_t lut[4][16];    /* lut[k][v]：第 k 个半字节取值 v 时应置高的引脚 */
+    rt_uint16_t bit_mask[16];  /* 数据位 i 对应的引脚掩码 */
+};
+
+/**
+ * @brief  初始化并行总线。
+ *
+ * @param[out] bus    总线控制块。
+ * @param[in]  pins   各数据位对应的引脚，`pins[0]` 为最低位。
+ * @param[in]  width  数据位数（1~16）。
+ * @param[in]  mode   引脚模式，如 `PIN_MODE_OUTPUT`、`PIN_MODE_INPUT`。
+ *
+ * @return `RT_EOK` 表示成功，`-RT_EINVAL` 表示位数越界或引脚不在同一端口。
+ */
+rt_err_t gpio_bus_init(struct gpio_bus *bus, const rt_base_t *pins, rt_uint8_t width, rt_base_t mode)
+{
+    rt_uint8_t i, k, v;
+
+    if (width == 0 || width > 16)
+        return -RT_EINVAL;
+
+    rt_memset(bus, 0, sizeof(*bus));
+    bus->port = GPIO_PIN_PORT(pins[0]);
+    bus->width = width;
+    bus->shift = (rt_uint8_t)(pins[0] & 0x0F);
+    for (i = 0; i < width; i++)
+    {
+        if (GPIO_PIN_PORT(pins[i]) != bus->port)
+        {
+            LOG_E("gpio_bus pin %d not on the same port...\n", pins[i]);
+            return -RT_EINVAL;
+        }
+        if (pins[i] != pins[0] + i)
+            bus->shift = 0xFF;
+        bus->bit_mask[i] = GPIO_PIN_MASK(pins[i]);
+        bus->mask |= bus->bit_mask[i];
+        rt_pin_mode(pins[i], mode);
+    }
+    for (k = 0; k < 4; k++)
+    {
+        for (v = 0; v < 16; v++)
+        {
+            for (i = 0; i < 4 && k * 4 + i < width; i++)
+            {
+                if (v & (1 << i))
+                    bus->lut[k][v] |= bus->bit_mask[k * 4 + i];
+            }
+        }
+    }
+    LOG_D("gpio_bus init succeeded...\n");
+    return RT_EOK;
+}
+
+/**
+ * @brief  把 `value` 的低 `width` 位一次性输出到总线。
+ */
+rt_inline void gpio_bus_write(const struct gpio_bus *bus, rt_uint16_t value)
+{
+    rt_uint16_t set;
+
+    if (bus->shift != 0xFF)
+        set = (rt_uint16_t)(value << bus->shift) & bus->mask;
+    else
+        set = bus->lut[0][value & 0x0F] | bus->lut[1][(value >> 4) & 0x0F] |
+              bus->lut[2][(value >> 8) & 0x0F] | bus->lut[3][value >> 12];
+    gpio_port_write(bus->port, set, bus->mask & ~set);
+}
+
+/**
+ * @brief  一次读取总线上的全部数据位。
+ */
+rt_inline rt_uint16_t gpio_bus_read(const struct gpio_bus *bus)
+{
+    rt_uint16_t idr = gpio_port_read(bus->port);
+    rt_uint16_t value = 0;
+    rt_uint8_t i;
+
+    if (bus->shift != 0xFF)
+        return (rt_uint16_t)((idr & bus->mask) >> bus->shift);
+    for (i = 0; i < bus->width; i++)
+    {
+        if (idr & bus->bit_mask[i])
+            value |= (rt_uint16_t)(1U << i);
+    }
+    return value;
+}
+#endif /* GET_PIN && GPIOA_BASE */
+
+/*
+ * GPIO 中断到事件集的分发器。
+ *
+ * 多个输入引脚的中断映射到同一个事件集（由 `event_generator` 创建）的不同位上，
+ * 中断里只记录"哪个位有边沿"并（必要时）启动一个公共的单次定时器；每个引脚在最后一次
+ * 边沿后经过各自的消抖时间才算稳定，定时器到期时把所有已稳定的位合并成一次 `rt_event_send`。
+ * 抖动期间的多次边沿、以及同一窗口内多个引脚的变化都只产生一次事件发送与一次线程唤醒。
+ */
+#define GPIO_EVENT_MAX_PINS 32
+
+struct gpio_event_dispatcher;
+
+struct gpio_event_pin
+{
+    struct gpio_event_dispatcher *owner;
+    rt_base_t pin;
+    rt_uint32_t mode;       /* PIN_IRQ_MODE_xxx，消抖结束时按其校验电平 */
+    rt_tick_t debounce;     /* 消抖时间（tick），至少为 1 */
+    rt_tick_t deadline;     /* 最近一次边沿后的稳定时刻 */
+    rt_uint32_t set;        /* 对应的事件位 */
+};
+
+struct gpio_event_dispatcher
+{
+    rt_event_t event;
+    struct rt_timer timer;
+    struct gpio_event_pin pins[GPIO_EVENT_MAX_PINS];
+    rt_uint8_t pin_count;
+    rt_bool_t timer_active;
+    rt_bool_t is_dynamic;
+    volatile rt_uint32_t pending;   /* 正在消抖的引脚下标位图 */
+    repack_lock_t lock;             /* 保护 pending 与 timer_active，引脚中断与定时器可能在不同核上 */
+};
+typedef struct gpio_event_dispatcher *gpio_event_dispatcher_t;
+
+static void gpio_event_arm(struct gpio_event_dispatcher *d, rt_tick_t delay)
+{
+    rt_timer_control(&d->timer, RT_TIMER_CTRL_SET_TIME, &delay);
+    rt_timer_start(&d->timer);
+    d->timer_active = RT_TRUE;
+}
+
+static void gpio_event_irq(void *args)
+{
+    struct gpio_event_pin *p = (struct gpio_event_pin *)args;
+    struct gpio_event_dispatcher *d = p->owner;
+    rt_base_t level;
+
+    level = repack_lock(&d->lock);
+    p->deadline = rt_tick_get() + p->debounce;
+    d->pending |= 1UL << (p - d->pins);
+    if (!d->timer_active)
+        gpio_event_arm(d, p->debounce);
+    repack_unlock(&d->lock, level);
+}
+
+static rt_bool_t gpio_event_level_ok(const struct gpio_event_pin *p)
+{
+    if (p->mode == PIN_IRQ_MODE_RISING)
+        return rt_pin_read(p->pin) == PIN_HIGH;
+    if (p->mode == PIN_IRQ_MODE_FALLING)
+        return rt_pin_read(p->pin) == PIN_LOW;
+    return RT_TRUE;
+}
+
+static void gpio_event_timeout(void *parameter)
+{
+    struct gpio_event_dispatcher *d = (struct gpio_event_dispatcher *)parameter;
+    rt_tick_t now = rt_tick_get();
+    rt_tick_t next = RT_TICK_MAX;
+    rt_uint32_t fire = 0;
+    rt_base_t level;
+    rt_uint8_t i;
+
+    level = repack_lock(&d->lock);
+    d->timer_active = RT_FALSE;
+    for (i = 0; i < d->pin_count; i++)
+    {
+        struct gpio_event_pin *p = &d->pins[i];
+        rt_int32_t remain;
+
+        if (!(d->pending & (1UL << i)))
+            continue;
+        remain = (rt_int32_t)(p->deadline - now);
+        if (remain > 0)
+        {
+            if ((rt_tick_t)remain < next)
+                next = remain;
+            continue;
+        }
+        d->pending &= ~(1UL << i);
+        if (gpio_event_level_ok(p))
+            fire |= p->set;
+    }
+    if (next != RT_TICK_MAX)
+        gpio_event_arm(d, next);
+    repack_unlock(&d->lock, level);
+
+    if (fire)
+        rt_event_send(d->event, fire);
+}
+
+/**
+ * @brief  创建或初始化一个 GPIO 事件分发器，支持动态和静态创建。
+ *
+ * @param[in,out] d_ptr       指向分发器控制块的指针。
+ *                            - 若 `is_dynamic` 为 `RT_FALSE`（静态创建），
+ *                              则需传入已分配的控制块地址。可定义全局：`struct gpio_event_dispatcher d;`
+ *                            - 若 `is_dynamic` 为 `RT_TRUE`（动态创建），
+ *                              则传入一个值 `RT_NULL` 的指针，内核将动态分配内存。可定义全局：`gpio_event_dispatcher_t d = RT_NULL;`
+ * @param[in]     name        分发器名称（用于内部定时器）。
+ * @param[in]     event       接收事件的事件集，由 `event_generator` 创建。
+ * @param[in]     is_dynamic  指示是否动态创建。
+ *
+ * @return `RT_EOK` 表示成功，`-ENOMEM` 表示内存不足导致动态创建失败。
+ */
+rt_err_t gpio_event_dispatcher_generator(gpio_event_dispatcher_t *d_ptr,
+                                         const char *name,
+                                         rt_event_t event,
+                                         rt_bool_t is_dynamic)
+{
+    if (is_dynamic)
+    {
+        *d_ptr = (gpio_event_dispatcher_t)repack_malloc(sizeof(struct gpio_event_dispatcher));
+        if (*d_ptr == RT_NULL)
+        {
+            LOG_E("gpio_event_dispatcher malloc failed...\n");
+            return -ENOMEM;
+        }
+        repack_heap_tag(*d_ptr, sizeof(struct gpio_event_dispatcher), REPACK_HEAP_GPIO_DISPATCHER, name);
+    }
+    rt_memset(*d_ptr, 0, sizeof(struct gpio_event_dispatcher));
+    (*d_ptr)->event = event;
+    (*d_ptr)->is_dynamic = is_dynamic;
+    repack_lock_init(&(*d_ptr)->lock);
+    rt_timer_init(&(*d_ptr)->timer, name, gpio_event_timeout, *d_ptr, 1,
+                  RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_HARD_TIMER);
+    LOG_D("gpio_event_dispatcher init succeeded...\n");
+    return RT_EOK;
+}
+
+/**
+ * @brief  把一个引脚的中断映射到事件位，并立即使能该引脚中断。
+ *
+ * @param[in] d            分发器。
+ * @param[in] pin          引脚编号，如 `GET_PIN(A, 0)`。
+ * @param[in] mode         中断触发方式 `PIN_IRQ_MODE_xxx`；单边沿模式在消抖结束时还会校验电平。
+ * @param[in] debounce_ms  消抖时间（毫秒），不足一个 tick 按一个 tick 计，同时也是合并窗口。
+ * @param[in] set          引脚稳定后发送的事件位，多个引脚可共用同一位。
+ *
+ * @return `RT_EOK` 表示成功，`-RT_EFULL` 表示引脚数已达上限，其他值为引脚中断配置失败。
+ */
+rt_err_t gpio_event_dispatcher_add(gpio_event_dispatcher_t d,
+                                   rt_base_t pin,
+                                   rt_uint32_t mode,
+                                   rt_int32_t debounce_ms,
+                                   rt_uint32_t set)
+{
+    struct gpio_event_pin *p;
+    rt_err_t ret;
+
+    if (d->pin_count >= GPIO_EVENT_MAX_PINS)
+        return -RT_EFULL;
+
+    p = &d->pins[d->pin_count];
+    p->owner = d;
+    p->pin = pin;
+    p->mode = mode;
+    p->set = set;
+    p->debounce = rt_tick_from_millisecond(debounce_ms);
+    if (p->debounce == 0)
+        p->debounce = 1;
+
+    ret = rt_pin_attach_irq(pin, mode, gpio_event_irq, p);
+    if (ret != RT_EOK)
+    {
+        LOG_E("gpio_event_dispatcher attach irq failed...\n");
+        return ret;
+    }
+    d->pin_count++;
+    return rt_pin_irq_enable(pin, PIN_IRQ_ENABLE);
+}
+
+/**
+ * @brief  关闭所有引脚中断并释放分发器，动态创建的同时释放内存。
+ */
+rt_err_t gpio_event_dispatcher_delete(gpio_event_dispatcher_t d)
+{
+    rt_uint8_t i;
+
+    for (i = 0; i < d->pin_count; i++)
+    {
+        rt_pin_irq_enable(d->pins[i].pin, PIN_IRQ_DISABLE);
+        rt_pin_detach_irq(d->pins[i].pin);
+    }
+    rt_timer_detach(&d->timer);
+    if (d->is_dynamic)
+    {
+        repack_heap_untag(d);
+        repack_free(d);
+    }
+    return RT_EOK;
+}
+
+#ifdef RTREPACK_USING_THREAD_REGISTRY
+/*
+ * 线程登记表：为 `thread_generator` 创建的线程分配从 1 开始的小整数编号，
+ * 供切换标记、采样剖析等功能把线程压缩成几位编码。未登记的线程编号为 0。
+ */
+static rt_thread_t repack_threads[RTREPACK_THREAD_REGISTRY_SIZE];
+/* 登记与注销可能同时发生在不同核上；查询只读一个指针，不加锁（静态清零即为未上锁） */
+static repack_lock_t repack_threads_lock;
+
+/**
+ * @brief  登记一个线程（`thread_generator` 创建的线程会自动登记，其余线程可手动登记）。
+ *
+ * @return 分配的编号（1 起），登记表已满返回 0。
+ */
+rt_uint8_t repack_thread_register(rt_thread_t thread)
+{
+    rt_uint8_t i, id = 0;
+    rt_base_t level;
+
+    // 手动登记的线程同样要在删除时注销
+    repack_detach_hook_install();
+    level = repack_lock(&repack_threads_lock);
+    for (i = 0; i < RTREPACK_THREAD_REGISTRY_SIZE; i++)
+    {
+        if (repack_threads[i] == thread)
+        {
+            id = i + 1;
+            break;
+        }
+        if (repack_threads[i] == RT_NULL && id == 0)
+            id = i + 1;
+    }
+    if (id != 0)
+        repack_threads[id - 1] = thread;
+    repack_unlock(&repack_threads_lock, level);
+    if (id == 0)
+        LOG_W("thread registry full, %.*s not registered\n", RT_NAME_MAX, thread->name);
+    return id;
+}
+
+/**
+ * @brief  注销线程，释放其编号。
+ */
+void repack_thread_unregister(rt_thread_t thread)
+{
+    rt_uint8_t i;
+    rt_base_t level;
+
+    level = repack_lock(&repack_threads_lock);
+    for (i = 0; i < RTREPACK_THREAD_REGISTRY_SIZE; i++)
+    {
+        if (repack_threads[i] == thread)
+            repack_threads[i] = RT_NULL;
+    }
+    repack_unlock(&repack_threads_lock, level);
+}
+
+/**
+ * @brief  查询线程编号，未登记返回 0。
+ */
+rt_inline rt_uint8_t repack_thread_id(rt_thread_t thread)
+{
+    rt_uint8_t i;
+
+    for (i = 0; i < RTREPACK_THREAD_REGISTRY_SIZE; i++)
+    {
+        if (repack_threads[i] == thread)
+            return i + 1;
+    }
+    return 0;
+}
+#endif /* RTREPACK_USING_THREAD_REGISTRY */
+
+#ifdef RTREPACK_USING_SCHED_HOOK
+/* 内核只有一个调度器钩子，由此分发给切换标记、负载均衡等功能 */
+typedef void (*repack_sched_hook_t)(struct rt_thread *from, struct rt_thread *to);
+
+#define REPACK_SCHED_HOOK_TRACE     0
+#define REPACK_SCHED_HOOK_BALANCER  1
+#define REPACK_SCHED_HOOKS          2
+
+static repack_sched_hook_t repack_sched_hooks[REPACK_SCHED_HOOKS];
+
+static void repack_sched_dispatch(struct rt_thread *from, struct rt_thread *to)
+{
+    rt_uint8_t i;
+
+    for (i = 0; i < REPACK_SCHED_HOOKS; i++)
+    {
+        if (repack_sched_hooks[i] != RT_NULL)
+            repack_sched_hooks[i](from, to);
+    }
+}
+
+/* 设置或清除（hook 为 RT_NULL）某一功能的调度钩子，全部清除后卸下内核钩子 */
+static void repack_sched_hook_set(rt_uint8_t slot, repack_sched_hook_t hook)
+{
+    rt_bool_t any = RT_FALSE;
+    rt_uint8_t i;
+
+    repack_sched_hooks[slot] = hook;
+    for (i = 0; i < REPACK_SCHED_HOOKS; i++)
+        any = any || (repack_sched_hooks[i] != RT_NULL);
+    rt_scheduler_sethook(any ? repack_sched_dispatch : RT_NULL);
+}
+#endif /* RTREPACK_USING_SCHED_HOOK */
+
+#if defined(RTREPACK_USING_SCHED_TRACE) && defined(GET_PIN) && defined(GPIOA_BASE)
+/*
+ * 线程切换 GPIO 标记：在调度器钩子中把即将运行的线程编码输出到同一端口的几个引脚上
+ * （一次 BSRR 写入），逻辑分析仪采到的电平序列即为各线程的运行时间线，
+ * 用 tools/sched_trace_decode.py 配合 `sched_trace_dump_map` 的输出解码。
+ */
+#define SCHED_TRACE_MODE_ID        0   /* 输出线程登记编号，未登记线程为 0 */
+#define SCHED_TRACE_MODE_PRIORITY  1   /* 输出线程当前优先级 */
+
+static struct
+{
+    struct gpio_bus bus;
+    rt_uint8_t mode;
+    rt_uint16_t code_mask;
+} sched_trace_ctx;
+
+static void sched_trace_hook(struct rt_thread *from, struct rt_thread *to)
+{
+    rt_uint16_t code;
+
+    (void)from;
+    if (sched_trace_ctx.mode == SCHED_TRACE_MODE_PRIORITY)
+        code = repack_thread_cur_priority(to);
+    else
+        code = repack_thread_id(to);
+    gpio_bus_write(&sched_trace_ctx.bus, code & sched_trace_ctx.code_mask);
+}
+
+/**
+ * @brief  启动线程切换标记。
+ *
+ * @param[in] pins   编码输出引脚，`pins[0]` 为最低位，须位于同一端口。
+ * @param[in] count  引脚数；编号模式下最多区分 2^count - 1 个线程。
+ * @param[in] mode   `SCHED_TRACE_MODE_ID` 或 `SCHED_TRACE_MODE_PRIORITY`。
+ *
+ * @return `RT_EOK` 表示成功，`-RT_EINVAL` 表示引脚配置无效。
+ */
+rt_err_t sched_trace_start(const rt_base_t *pins, rt_uint8_t count, rt_uint8_t mode)
+{
+    rt_err_t ret = gpio_bus_init(&sched_trace_ctx.bus, pins, count, PIN_MODE_OUTPUT);
+
+    if (ret != RT_EOK)
+        return ret;
+    sched_trace_ctx.mode = mode;
+    sched_trace_ctx.code_mask = (rt_uint16_t)((1UL << count) - 1);
+    repack_sched_hook_set(REPACK_SCHED_HOOK_TRACE, sched_trace_hook);
+    return RT_EOK;
+}
+
+/**
+ * @brief  停止线程切换标记。
+ */
+void sched_trace_stop(void)
+{
+    repack_sched_hook_set(REPACK_SCHED_HOOK_TRACE, RT_NULL);
+}
+
+/**
+ * @brief  输出编码到线程名的映射，每行 `sched_trace,<code>,<name>`，供解码脚本使用。
+ */
+void sched_trace_dump_map(void)
+{
+    rt_uint8_t i;
+
+    rt_kprintf("sched_trace,0,%s\n", sched_trace_ctx.mode == SCHED_TRACE_MODE_ID ? "(other)" : "prio0");
+    for (i = 0; i < RTREPACK_THREAD_REGISTRY_SIZE && sched_trace_ctx.mode == SCHED_TRACE_MODE_ID; i++)
+    {
+        if (repack_threads[i] != RT_NULL && i + 1 <= sched_trace_ctx.code_mask)
+            rt_kprintf("sched_trace,%d,%.*s\n", i + 1, RT_NAME_MAX, repack_threads[i]->name);
+    }
+}
+#endif /* RTREPACK_USING_SCHED_TRACE */
+
+#ifdef RTREPACK_USING_PROFILER
+/*
+ * 定时中断采样剖析。
+ *
+ * 高优先级定时中断中调用 `profiler_sample_isr`（或由 `profiler_start` 挂到系统节拍钩子上），
+ * 取被中断代码的 PC 与当前线程编号写入单生产者/单消费者无锁环形缓冲；低优先级汇总线程
+ * 把样本按 (线程, PC) 计数。`profiler_dump` 输出 `prof,<thread>,<pc>,<count>` 行，
+ * 由 tools/profiler_hist.py 解析符号并按函数汇总。
+ *
+ * 只记录被中断处的 PC，不回溯调用栈，结果是各函数自身耗时的平坦直方图，
+ * 调用者不会计入被调函数的时间。
+ *
+ * Cortex-M 上线程使用 PSP，被中断线程的 PC 位于 PSP 所指异常栈帧的第 7 个字；
+ * 其他架构没有可移植的取法，PC 一律记为 0，只能得到按线程的分布。
+ * 中断嵌套时被打断的是另一个中断，只记为 "[irq]"。
+ *
+ * 挂在节拍钩子上采样时，采样点与节拍同相：每次都落在节拍中断及其唤醒的线程刚开始
+ * 运行的时刻，周期与节拍同步的工作会被系统性地多算或漏算。需要无偏的结果时以
+ * `divider` 为 0 启动，在一个与节拍无关（频率不是节拍整数倍）的独立硬件定时器中断里
+ * 调用 `profiler_sample_isr`。
+ */
+#define PROFILER_THREAD_IRQ 0xFF
+
+struct profiler_sample
+{
+    rt_uint32_t pc;
+    rt_uint8_t thread;      /* 线程登记编号，0 为未登记线程，PROFILER_THREAD_IRQ 为中断 */
+};
+
+struct profiler_slot
+{
+    rt_uint32_t pc;
+    rt_uint32_t count;
+    rt_uint8_t thread;
+};
+
+static struct
+{
+    struct profiler_sample ring[RTREPACK_PROFILER_RING];
+    volatile rt_uint32_t head;  /* 仅中断写 */
+    volatile rt_uint32_t tail;  /* 仅汇总线程写 */
+    rt_uint32_t dropped;
+    rt_uint32_t divider;
+    rt_uint32_t countdown;
+    void (*chain)(void);        /* 剖析期间代为调用的原节拍钩子 */
+    struct profiler_slot slots[RTREPACK_PROFILER_SLOTS];
+    rt_uint32_t overflow;       /* 汇总表已满时丢弃的样本 */
+    rt_uint32_t total;
+    struct rt_thread thread;
+    rt_uint8_t stack[1024];
+    struct rt_semaphore exited; /* 汇总线程处理完剩余样本后释放，`profiler_stop` 在此等待 */
+    volatile rt_bool_t running;
+} profiler_ctx;
+
+/**
+ * @brief  采集一个样本。应在高优先级定时中断中（`rt_interrupt_enter` 之后）调用。
+ */
+void profiler_sample_isr(void)
+{
+    struct profiler_sample *sample;
+    rt_uint32_t head = profiler_ctx.head;
+
+    if (!profiler_ctx.running)
+        return;
+    if (head - profiler_ctx.tail >= RTREPACK_PROFILER_RING)
+    {
+        profiler_ctx.dropped++;
+        return;
+    }
+    sample = &profiler_ctx.ring[head & (RTREPACK_PROFILER_RING - 1)];
+    if (rt_interrupt_get_nest() > 1)
+    {
+        sample->pc = 0;
+        sample->thread = PROFILER_THREAD_IRQ;
+    }
+    else
+    {
+#if defined(__CORTEX_M)
+        sample->pc = ((rt_uint32_t *)(rt_ubase_t)__get_PSP())[6];
+#else
+        sample->pc = 0;
+#endif
+        sample->thread = repack_thread_id(rt_thread_self());
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(&profiler_ctx.head, head + 1, __ATOMIC_RELEASE);
+#else
+    profiler_ctx.head = head + 1;
+#endif
+}
+
+static void profiler_tick_hook(void)
+{
+    if (profiler_ctx.chain != RT_NULL)
+        profiler_ctx.chain();
+    if (--profiler_ctx.countdown == 0)
+    {
+        profiler_ctx.countdown = profiler_ctx.divider;
+        profiler_sample_isr();
+    }
+}
+
+static void profiler_account(const struct profiler_sample *sample)
+{
+    rt_uint32_t hash = (sample->pc >> 1) ^ ((rt_uint32_t)sample->thread * 0x9E3779B1UL);
+    rt_uint32_t n;
+
+    profiler_ctx.total++;
+    for (n = 0; n < RTREPACK_PROFILER_SLOTS; n++)
+    {
+        struct profiler_slot *slot = &profiler_ctx.slots[(hash + n) % RTREPACK_PROFILER_SLOTS];
+
+        if (slot->count == 0)
+        {
+            slot->pc = sample->pc;
+            slot->thread = sample->thread;
+        }
+        if (slot->pc == sample->pc && slot->thread == sample->thread)
+        {
+            slot->count++;
+            return;
+        }
+    }
+    profiler_ctx.overflow++;
+}
+
+static void profiler_entry(void *parameter)
+{
+    rt_bool_t running;
+
+    (void)parameter;
+    do
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        rt_uint32_t head = __atomic_load_n(&profiler_ctx.head, __ATOMIC_ACQUIRE);
+#else
+        rt_uint32_t head = profiler_ctx.head;
+#endif
+        running = profiler_ctx.running;
+        while (profiler_ctx.tail != head)
+        {
+            profiler_account(&profiler_ctx.ring[profiler_ctx.tail & (RTREPACK_PROFILER_RING - 1)]);
+            profiler_ctx.tail++;
+        }
+        if (running)
+            rt_thread_mdelay(10);
+    } while (running);
+    rt_sem_release(&profiler_ctx.exited);
+}
+
+/**
+ * @brief  登记应用已有的节拍钩子。
+ *
+ * `rt_tick_sethook` 只有一个槽位且无法读出当前值，`profiler_start` 挂钩会顶替应用的钩子。
+ * 应用在启动剖析前把自己的钩子交给本函数，剖析期间由剖析器转调，`profiler_stop` 时恢复。
+ */
+void profiler_set_chain_hook(void (*hook)(void))
+{
+    profiler_ctx.chain = hook;
+}
+
+/**
+ * @brief  启动采样剖析。
+ *
+ * @param[in] divider   每隔多少个系统节拍采样一次，采样与节拍同相；为 0 时不挂节拍钩子，
+ *                      由用户在自己配置的独立硬件定时器中断中调用 `profiler_sample_isr`，采样率即定时器频率。
+ * @param[in] priority  汇总线程优先级，一般取较低优先级。
+ *
+ * @return `RT_EOK` 表示成功，`-RT_EBUSY` 表示正在运行或上一次的汇总线程尚未被内核回收，
+ *         其他值为汇总线程创建失败。
+ */
+rt_err_t profiler_start(rt_uint32_t divider, rt_uint8_t priority)
+{
+    rt_thread_t thread = &profiler_ctx.thread;
+    rt_err_t ret;
+
+    if (profiler_ctx.running || repack_thread_listed(thread))
+        return -RT_EBUSY;
+    rt_sem_init(&profiler_ctx.exited, "profx", 0, RT_IPC_FLAG_FIFO);
+    rt_memset(profiler_ctx.slots, 0, sizeof(profiler_ctx.slots));
+    profiler_ctx.head = profiler_ctx.tail = 0;
+    profiler_ctx.dropped = profiler_ctx.overflow = profiler_ctx.total = 0;
+    profiler_ctx.running = RT_TRUE;
+
+    ret = thread_generator(&thread, "prof", profiler_entry, RT_NULL, profiler_ctx.stack,
+                           sizeof(profiler_ctx.stack), priority, 10, RT_FALSE);
+    if (ret != RT_EOK)
+    {
+        profiler_ctx.running = RT_FALSE;
+        rt_sem_detach(&profiler_ctx.exited);
+        return ret;
+    }
+    rt_thread_startup(thread);
+
+    profiler_ctx.divider = profiler_ctx.countdown = divider;
+    if (divider != 0)
+        rt_tick_sethook(profiler_tick_hook);
+    return RT_EOK;
+}
+
+/**
+ * @brief  停止采样，等待汇总线程处理完剩余样本并退出后返回。不能在中断中调用。
+ */
+void profiler_stop(void)
+{
+    if (!profiler_ctx.running)
+        return;
+    if (profiler_ctx.divider != 0)
+        rt_tick_sethook(profiler_ctx.chain);
+    profiler_ctx.running = RT_FALSE;
+    rt_sem_take(&profiler_ctx.exited, RT_WAITING_FOREVER);
+    rt_sem_detach(&profiler_ctx.exited);
+}
+
+/**
+ * @brief  输出汇总结果，每行 `prof,<thread>,<pc>,<count>`。
+ */
+void profiler_dump(void)
+{
+    rt_uint32_t i;
+
+    rt_kprintf("prof,# samples %d, dropped %d, overflow %d\n", profiler_ctx.total, profiler_ctx.dropped,
+               profiler_ctx.overflow);
+    for (i = 0; i < RTREPACK_PROFILER_SLOTS; i++)
+    {
+        const struct profiler_slot *slot = &profiler_ctx.slots[i];
+        rt_thread_t thread;
+
+        if (slot->count == 0)
+            continue;
+        if (slot->thread == PROFILER_THREAD_IRQ)
+        {
+            rt_kprintf("prof,[irq],0x%08x,%d\n", slot->pc, slot->count);
+            continue;
+        }
+        thread = (slot->thread != 0) ? repack_threads[slot->thread - 1] : RT_NULL;
+        rt_kprintf("prof,%.*s,0x%08x,%d\n", RT_NAME_MAX, thread ? thread->name : "[other]", slot->pc,
+                   slot->count);
+    }
+}
+
+#ifdef RT_USING_FINSH
+#include <stdlib.h>
+
+static int profiler(int argc, char **argv)
+{
+    if (argc >= 2 && !rt_strncmp(argv[1], "start", 5))
+        return profiler_start(argc >= 3 ? atoi(argv[2]) : 1, RT_THREAD_PRIORITY_MAX - 2);
+    if (argc >= 2 && !rt_strncmp(argv[1], "stop", 4))
+        profiler_stop();
+    else if (argc >= 2 && !rt_strncmp(argv[1], "dump", 4))
+        profiler_dump();
+    else
+        rt_kprintf("usage: profiler start [divider]|stop|dump\n");
+    return 0;
+}
+MSH_CMD_EXPORT(profiler, sampling profiler);
+#endif /* RT_USING_FINSH */
+#endif /* RTREPACK_USING_PROFILER */
+
+#ifdef RTREPACK_USING_HEAP_MONITOR
+/*
+ * 动态分配监视：生成器动态创建对象成功后，按对象类型与名称前缀登记其占用的字节数
+ * （控制块 + 线程栈/邮箱池/消息池），对象删除时经内核对象脱离钩子扣除；
+ * 库自身类型由各自的生成器按整块分配的字节数登记、由删除函数扣除，
+ * 统计当前占用、峰值与次数；报告时另给出堆的总量、已用、历史峰值与最大可用块，
+ * 用于判断哪些子系统应改为静态或内存池分配。
+ */
+struct heap_monitor_stat
+{
+    rt_size_t live;
+    rt_size_t peak;
+    rt_uint32_t count;      /* 当前存活对象数 */
+    rt_uint32_t total;      /* 累计创建次数 */
+};
+
+struct heap_monitor_prefix
+{
+    char name[RTREPACK_HEAP_MONITOR_PREFIX_LEN + 1];
+    struct heap_monitor_stat stat;
+};
+
+struct heap_monitor_tag
+{
+    const void *ptr;
+    rt_size_t bytes;
+    rt_uint8_t kind;
+    rt_uint8_t prefix;
+};
+
+static struct
+{
+    struct heap_monitor_tag tags[RTREPACK_HEAP_MONITOR_OBJECTS];
+    struct heap_monitor_stat kinds[REPACK_HEAP_KINDS];
+    struct heap_monitor_prefix prefixes[RTREPACK_HEAP_MONITOR_PREFIXES];
+    rt_uint8_t prefix_count;
+    rt_uint32_t untracked;
+} heap_monitor_ctx;
+
+/* 对象占用的动态内存字节数（不含分配器自身的块头） */
+static rt_size_t heap_monitor_bytes(rt_object_t object, rt_uint8_t type)
+{
+    switch (type)
+    {
+    case RT_Object_Class_Thread:
+        return sizeof(struct rt_thread) + ((rt_thread_t)object)->stack_size;
+    case RT_Object_Class_Semaphore:
+        return sizeof(struct rt_semaphore);
+    case RT_Object_Class_Mutex:
+        return sizeof(struct rt_mutex);
+    case RT_Object_Class_Event:
+        return sizeof(struct rt_event);
+    case RT_Object_Class_MailBox:
+        return sizeof(struct rt_mailbox) + ((rt_mailbox_t)object)->size * sizeof(rt_ubase_t);
+    case RT_Object_Class_MessageQueue:
+        return sizeof(struct rt_messagequeue) +
+               ((rt_mq_t)object)->max_msgs *
+                   (RT_ALIGN(((rt_mq_t)object)->msg_size, RT_ALIGN_SIZE) + REPACK_MQ_MSG_HDR_SIZE);
+    }
+    return 0;
+}
+
+/* 取名称前缀对应的统计项，无名称的对象归入空前缀，调用方已关中断 */
+static rt_uint8_t heap_monitor_prefix_index(const char *name)
+{
+    char prefix[RTREPACK_HEAP_MONITOR_PREFIX_LEN + 1] = {0};
+    rt_uint8_t i;
+
+    for (i = 0; name != RT_NULL && i < RTREPACK_HEAP_MONITOR_PREFIX_LEN && i < RT_NAME_MAX && name[i] != '\0' &&
+                name[i] != '_' && (name[i] < '0' || name[i] > '9');
+         i++)
+        prefix[i] = name[i];
+
+    for (i = 0; i < heap_monitor_ctx.prefix_count; i++)
+    {
+        if (rt_strncmp(heap_monitor_ctx.prefixes[i].name, prefix, sizeof(prefix)) == 0)
+            return i;
+    }
+    if (i >= RTREPACK_HEAP_MONITOR_PREFIXES)
+        return RTREPACK_HEAP_MONITOR_PREFIXES - 1; /* 表满后归入最后一项 */
+    rt_memcpy(heap_monitor_ctx.prefixes[i].name, prefix, sizeof(prefix));
+    heap_monitor_ctx.prefix_count++;
+    return i;
+}
+
+static void heap_monitor_stat_add(struct heap_monitor_stat *stat, rt_size_t bytes)
+{
+    stat->live += bytes;
+    stat->count++;
+    stat->total++;
+    if (stat->live > stat->peak)
+        stat->peak = stat->live;
+}
+
+static void heap_monitor_stat_sub(struct heap_monitor_stat *stat, rt_size_t bytes)
+{
+    stat->live -= bytes;
+    stat->count--;
+}
+
+/* 登记一块动态内存，ptr 为撤销时的键 */
+static void heap_monitor_tag(const void *ptr, rt_size_t bytes, rt_uint8_t kind, const char *name)
+{
+    rt_base_t level;
+    rt_uint16_t i;
+
+    level = rt_hw_interrupt_disable();
+    for (i = 0; i < RTREPACK_HEAP_MONITOR_OBJECTS; i++)
+    {
+        struct heap_monitor_tag *tag = &heap_monitor_ctx.tags[i];
+
+        if (tag->ptr != RT_NULL)
+            continue;
+        tag->ptr = ptr;
+        tag->bytes = bytes;
+        tag->kind = kind;
+        tag->prefix = heap_monitor_prefix_index(name);
+        heap_monitor_stat_add(&heap_monitor_ctx.kinds[kind], bytes);
+        heap_monitor_stat_add(&heap_monitor_ctx.prefixes[tag->prefix].stat, bytes);
+        break;
+    }
+    if (i == RTREPACK_HEAP_MONITOR_OBJECTS)
+        heap_monitor_ctx.untracked++;
+    rt_hw_interrupt_enable(level);
+}
+
+static void heap_monitor_untag(const void *ptr)
+{
+    rt_base_t level;
+    rt_uint16_t i;
+
+    level = rt_hw_interrupt_disable();
+    for (i = 0; i < RTREPACK_HEAP_MONITOR_OBJECTS; i++)
+    {
+        struct heap_monitor_tag *tag = &heap_monitor_ctx.tags[i];
+
+        if (tag->ptr != ptr)
+            continue;
+        heap_monitor_stat_sub(&heap_monitor_ctx.kinds[tag->kind], tag->bytes);
+        heap_monitor_stat_sub(&heap_monitor_ctx.prefixes[tag->prefix].stat, tag->bytes);
+        tag->ptr = RT_NULL;
+        break;
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+static void heap_monitor_tag_object(rt_object_t object)
+{
+    rt_uint8_t type = rt_object_get_type(object);
+
+    if (type > RT_Object_Class_MessageQueue)
+        return;
+    heap_monitor_tag(object, heap_monitor_bytes(object, type), type, object->name);
+}
+
+/**
+ * @brief  探测堆中当前最大的可分配块（对分申请再释放，仅用于诊断）。
+ */
+rt_size_t heap_largest_free_block(void)
+{
+    rt_size_t total = 0, used = 0, max_used = 0;
+    rt_size_t lo = 0, hi, mid;
+    void *ptr;
+
+    rt_memory_info(&total, &used, &max_used);
+    hi = total - used;
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo + 1) / 2;
+        ptr = rt_malloc(mid);
+        if (ptr != RT_NULL)
+        {
+            rt_free(ptr);
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief  输出按类型、按名称前缀的动态内存统计以及堆碎片情况。
+ */
+void heap_monitor_dump(void)
+{
+    static const char *const kind_names[REPACK_HEAP_KINDS] = {
+        "?", "thread", "sem", "mutex", "event", "mailbox", "mq", "ceiling", "lite", "sharded", "io_ring",
+        "dma_pool", "triple", "inplace", "semcache", "complete", "stream", "gpio"};
+    rt_size_t total = 0, used = 0, max_used = 0, largest;
+    rt_uint8_t i;
+
+    rt_kprintf("kind     live     peak     count  total\n");
+    for (i = RT_Object_Class_Thread; i < REPACK_HEAP_KINDS; i++)
+    {
+        const struct heap_monitor_stat *stat = &heap_monitor_ctx.kinds[i];
+
+        if (stat->total)
+            rt_kprintf("%-8s %-8d %-8d %-6d %d\n", kind_names[i], stat->live, stat->peak, stat->count, stat->total);
+    }
+    rt_kprintf("prefix   live     peak     count  total\n");
+    for (i = 0; i < heap_monitor_ctx.prefix_count; i++)
+    {
+        const struct heap_monitor_prefix *prefix = &heap_monitor_ctx.prefixes[i];
+
+        rt_kprintf("%-8s %-8d %-8d %-6d %d\n", prefix->name[0] ? prefix->name : "-", prefix->stat.live,
+                   prefix->stat.peak, prefix->stat.count, prefix->stat.total);
+    }
+    if (heap_monitor_ctx.untracked)
+        rt_kprintf("untracked objects: %d\n", heap_monitor_ctx.untracked);
+
+    largest = heap_largest_free_block();
+    rt_memory_info(&total, &used, &max_used);
+    rt_kprintf("heap total %d, used %d, max used %d, free %d, largest free block %d (fragmentation %d%%)\n",
+               total, used, max_used, total - used, largest,
+               (total > used) ? (rt_uint32_t)(100 - (rt_uint64_t)largest * 100 / (total - used)) : 0);
+}
+
+#ifdef RT_USING_FINSH
+static int heap_monitor(void)
+{
+    heap_monitor_dump();
+    return 0;
+}
+MSH_CMD_EXPORT(heap_monitor, dynamic allocation footprint of library objects);
+#endif /* RT_USING_FINSH */
+#endif /* RTREPACK_USING_HEAP_MONITOR */
+
+#ifdef RTREPACK_USING_STATIC_POOLS
+/*
+ * 无堆配置下的静态对象池。
+ *
+ * 每类对象一组控制块数组，线程栈、邮箱池、消息池各有一块缓冲区，全部置于
+ * RTREPACK_POOL_SECTION 链接段。生成器收到动态请求时从对应池取一个空闲槽位：
+ * 优先复用缓冲区足够大的已释放槽位（最佳适配），否则从缓冲区顺序切出新区域，
+ * 因此分配结果只取决于创建/释放顺序，内存占用在编译期即可确定。
+ * 对象脱离时（包括静态线程退出时内核的自动脱离）经脱离钩子归还槽位，缓冲区随槽位保留以供复用。
+ * 天花板互斥量、环形队列、DMA 缓冲池等库自身对象经 repack_malloc 从块池整块取用，
+ * 同样按最佳适配复用，由各自的删除函数经 repack_free 归还。
+ */
+#define REPACK_POOL_ATTR RT_SECTION(RTREPACK_POOL_SECTION)
+
+/* 静态池总字节数，可在链接前核对 RAM 预算 */
+#define RTREPACK_POOL_TOTAL_BYTES                                              \
+    (RTREPACK_POOL_THREADS * sizeof(struct rt_thread) + RTREPACK_POOL_STACK_BYTES + \
+     RTREPACK_POOL_SEMS * sizeof(struct rt_semaphore) +                        \
+     RTREPACK_POOL_MUTEXES * sizeof(struct rt_mutex) +                         \
+     RTREPACK_POOL_EVENTS * sizeof(struct rt_event) +                          \
+     RTREPACK_POOL_MAILBOXES * sizeof(struct rt_mailbox) + RTREPACK_POOL_MB_BYTES + \
+     RTREPACK_POOL_MQS * sizeof(struct rt_messagequeue) + RTREPACK_POOL_MQ_BYTES + \
+     RTREPACK_POOL_BLOCK_BYTES)
+
+#ifdef RTREPACK_POOL_BUDGET_BYTES
+typedef char repack_pool_budget_check[(RTREPACK_POOL_TOTAL_BYTES <= RTREPACK_POOL_BUDGET_BYTES) ? 1 : -1];
+#endif
+
+struct repack_pool_slot
+{
+    rt_uint8_t *region;
+    rt_size_t region_size;
+    rt_bool_t in_use;
+};
+
+struct repack_pool
+{
+    const char *name;
+    rt_uint8_t *blocks;
+    rt_size_t block_size;
+    rt_uint16_t capacity;
+    rt_uint16_t used;
+    rt_uint16_t peak;
+    rt_uint16_t failed;
+    struct repack_pool_slot *slots;
+    rt_uint8_t *arena;
+    rt_size_t arena_size;
+    rt_size_t arena_used;
+    rt_size_t align;
+};
+
+static struct rt_thread repack_pool_threads[RTREPACK_POOL_THREADS] REPACK_POOL_ATTR;
+static rt_uint8_t repack_pool_stacks[RTREPACK_POOL_STACK_BYTES] REPACK_POOL_ATTR ALIGN(8);
+static struct rt_semaphore repack_pool_sems[RTREPACK_POOL_SEMS] REPACK_POOL_ATTR;
+static struct rt_mutex repack_pool_mutexes[RTREPACK_POOL_MUTEXES] REPACK_POOL_ATTR;
+static struct rt_event repack_pool_events[RTREPACK_POOL_EVENTS] REPACK_POOL_ATTR;
+static struct rt_mailbox repack_pool_mailboxes[RTREPACK_POOL_MAILBOXES] REPACK_POOL_ATTR;
+static rt_uint8_t repack_pool_mb_buf[RTREPACK_POOL_MB_BYTES] REPACK_POOL_ATTR ALIGN(8);
+static struct rt_messagequeue repack_pool_mqs[RTREPACK_POOL_MQS] REPACK_POOL_ATTR;
+static rt_uint8_t repack_pool_mq_buf[RTREPACK_POOL_MQ_BYTES] REPACK_POOL_ATTR ALIGN(8);
+static rt_uint8_t repack_pool_block_buf[RTREPACK_POOL_BLOCK_BYTES] REPACK_POOL_ATTR ALIGN(8);
+
+static struct repack_pool_slot repack_pool_thread_slots[RTREPACK_POOL_THREADS];
+static struct repack_pool_slot repack_pool_sem_slots[RTREPACK_POOL_SEMS];
+static struct repack_pool_slot repack_pool_mutex_slots[RTREPACK_POOL_MUTEXES];
+static struct repack_pool_slot repack_pool_event_slots[RTREPACK_POOL_EVENTS];
+static struct repack_pool_slot repack_pool_mb_slots[RTREPACK_POOL_MAILBOXES];
+static struct repack_pool_slot repack_pool_mq_slots[RTREPACK_POOL_MQS];
+static struct repack_pool_slot repack_pool_block_slots[RTREPACK_POOL_BLOCKS];
+
+static struct repack_pool repack_pools[REPACK_POOL_KINDS] = {
+    {"thread", (rt_uint8_t *)repack_pool_threads, sizeof(struct rt_thread), RTREPACK_POOL_THREADS, 0, 0, 0,
+     repack_pool_thread_slots, repack_pool_stacks, RTREPACK_POOL_STACK_BYTES, 0, 8},
+    {"sem", (rt_uint8_t *)repack_pool_sems, sizeof(struct rt_semaphore), RTREPACK_POOL_SEMS, 0, 0, 0,
+     repack_pool_sem_slots, RT_NULL, 0, 0, 1},
+    {"mutex", (rt_uint8_t *)repack_pool_mutexes, sizeof(struct rt_mutex), RTREPACK_POOL_MUTEXES, 0, 0, 0,
+     repack_pool_mutex_slots, RT_NULL, 0, 0, 1},
+    {"event", (rt_uint8_t *)repack_pool_events, sizeof(struct rt_event), RTREPACK_POOL_EVENTS, 0, 0, 0,
+     repack_pool_event_slots, RT_NULL, 0, 0, 1},
+    {"mailbox", (rt_uint8_t *)repack_pool_mailboxes, sizeof(struct rt_mailbox), RTREPACK_POOL_MAILBOXES, 0, 0, 0,
+     repack_pool_mb_slots, repack_pool_mb_buf, RTREPACK_POOL_MB_BYTES, 0, sizeof(rt_ubase_t)},
+    {"mq", (rt_uint8_t *)repack_pool_mqs, sizeof(struct rt_messagequeue), RTREPACK_POOL_MQS, 0, 0, 0,
+     repack_pool_mq_slots, repack_pool_mq_buf, RTREPACK_POOL_MQ_BYTES, 0, RT_ALIGN_SIZE},
+    {"block", RT_NULL, 0, RTREPACK_POOL_BLOCKS, 0, 0, 0,
+     repack_pool_block_slots, repack_pool_block_buf, RTREPACK_POOL_BLOCK_BYTES, 0, 8},
+};
+
+/*
+ * 取一个空闲槽位并为其准备 region_size 字节的缓冲区。
+ * 返回控制块地址（块池没有控制块，返回缓冲区地址），缓冲区地址写入 *region；
+ * 池或缓冲区耗尽时返回 RT_NULL。
+ */
+static void *repack_pool_alloc(rt_uint8_t kind, void **region, rt_size_t region_size)
+{
+    struct repack_pool *pool = &repack_pools[kind];
+    struct repack_pool_slot *best = RT_NULL, *fresh = RT_NULL;
+    rt_base_t level;
+    rt_uint16_t i;
+
+    region_size = RT_ALIGN(region_size, pool->align);
+    level = rt_hw_interrupt_disable();
+    for (i = 0; i < pool->capacity; i++)
+    {
+        struct repack_pool_slot *slot = &pool->slots[i];
+
+        if (slot->in_use)
+            continue;
+        if (slot->region_size >= region_size && (best == RT_NULL || slot->region_size < best->region_size))
+            best = slot;
+        if (slot->region_size == 0 && fresh == RT_NULL)
+            fresh = slot;
+    }
+    if (best == RT_NULL && fresh != RT_NULL && pool->arena_used + region_size <= pool->arena_size)
+    {
+        fresh->region = pool->arena + pool->arena_used;
+        fresh->region_size = region_size;
+        pool->arena_used += region_size;
+        best = fresh;
+    }
+    if (best == RT_NULL)
+    {
+        pool->failed++;
+        rt_hw_interrupt_enable(level);
+        return RT_NULL;
+    }
+    best->in_use = RT_TRUE;
+    if (++pool->used > pool->peak)
+        pool->peak = pool->used;
+    rt_hw_interrupt_enable(level);
+
+    if (region != RT_NULL)
+        *region = best->region;
+    if (pool->blocks == RT_NULL)
+        return best->region;
+    return pool->blocks + (best - pool->slots) * pool->block_size;
+}
+
+/* 库自身对象的内存，由 repack_malloc 调用 */
+static void *repack_pool_malloc(rt_size_t size)
+{
+    return repack_pool_alloc(REPACK_POOL_BLOCK, RT_NULL, size);
+}
+
+/* 归还 repack_pool_malloc 取得的内存，缓冲区随槽位保留 */
+static void repack_pool_free(void *ptr)
+{
+    struct repack_pool *pool = &repack_pools[REPACK_POOL_BLOCK];
+    rt_base_t level;
+    rt_uint16_t i;
+
+    if (ptr == RT_NULL)
+        return;
+    level = rt_hw_interrupt_disable();
+    for (i = 0; i < pool->capacity; i++)
+    {
+        if (pool->slots[i].in_use && pool->slots[i].region == ptr)
+        {
+            pool->slots[i].in_use = RT_FALSE;
+            pool->used--;
+            break;
+        }
+    }
+    rt_hw_interrupt_enable(level);
+    RT_ASSERT(i < pool->capacity);
+}
+
+static rt_bool_t repack_pool_owns(const void *object)
+{
+    rt_uint8_t k;
+
+    for (k = 0; k < REPACK_POOL_KINDS; k++)
+    {
+        const struct repack_pool *pool = &repack_pools[k];
+
+        if (pool->blocks == RT_NULL)
+            continue;
+        if ((const rt_uint8_t *)object >= pool->blocks &&
+            (const rt_uint8_t *)object < pool->blocks + pool->capacity * pool->block_size)
+            return RT_TRUE;
+    }
+    return RT_FALSE;
+}
+
+/* 对象脱离时归还槽位，缓冲区保留 */
+static void repack_pool_release(rt_object_t object)
+{
+    rt_base_t level;
+    rt_uint8_t k;
+
+    for (k = 0; k < REPACK_POOL_KINDS; k++)
+    {
+        struct repack_pool *pool = &repack_pools[k];
+        rt_size_t offset;
+
+        if (pool->blocks == RT_NULL || (rt_uint8_t *)object < pool->blocks)
+            continue;
+        offset = (rt_uint8_t *)object - pool->blocks;
+        if (offset >= pool->capacity * pool->block_size)
+            continue;
+        level = rt_hw_interrupt_disable();
+        if (pool->slots[offset / pool->block_size].in_use)
+        {
+            pool->slots[offset / pool->block_size].in_use = RT_FALSE;
+            pool->used--;
+        }
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+}
+
+/**
+ * @brief  输出各静态池的容量与使用情况（当前/峰值/失败次数、缓冲区已切分字节数）。
+ */
+void repack_pool_report(void)
+{
+    rt_uint8_t k;
+
+    rt_kprintf("static pools in %s: %d bytes\n", RTREPACK_POOL_SECTION, (rt_uint32_t)RTREPACK_POOL_TOTAL_BYTES);
+    rt_kprintf("kind     used/cap  peak  failed  buffer used/size\n");
+    for (k = 0; k < REPACK_POOL_KINDS; k++)
+    {
+        const struct repack_pool *pool = &repack_pools[k];
+
+        rt_kprintf("%-8s %3d/%-5d %-5d %-7d %d/%d\n", pool->name, pool->used, pool->capacity, pool->peak,
+                   pool->failed, pool->arena_used, pool->arena_size);
+    }
+}
+
+static int repack_pool_boot_report(void)
+{
+    repack_pool_report();
+    return 0;
+}
+INIT_APP_EXPORT(repack_pool_boot_report);
+
+#ifdef RT_USING_FINSH
+static int pool_report(void)
+{
+    repack_pool_report();
+    return 0;
+}
+MSH_CMD_EXPORT(pool_report, static object pool usage);
+#endif /* RT_USING_FINSH */
+#endif /* RTREPACK_USING_STATIC_POOLS */
+
+/*
+ * 排队延迟统计。
+ *
+ * 开启 RTREPACK_USING_IPC_LATENCY 后，生成器创建的邮箱与消息队列各自分配一个时间戳旁路环：
+ * 带时间戳的发送在该对象的统计锁内完成投递并按发送序号记下时间戳，接收后按接收序号取出
+ * 对应时间戳，把排队时间计入该对象的延迟直方图。消息本身不变，旁路环按序号对齐，
+ * 因此被观测对象上的全部发送与接收都应经由下面的 *_stamped 接口，且不能使用紧急发送；
+ * 积压超过 RTREPACK_IPC_LATENCY_DEPTH 条时最早的时间戳被覆盖，对应消息不计入统计。
+ * 多个接收者并发时相邻消息的时间戳可能互换，直方图整体不受影响。
+ * 未开启时这些接口等同于普通的非阻塞发送与接收。
+ */
+#ifdef RTREPACK_USING_IPC_LATENCY
+struct ipc_latency
+{
+    rt_object_t object;
+    repack_lock_t lock;         /* 保护序号、时间戳环与直方图 */
+    rt_uint32_t send_seq;
+    rt_uint32_t recv_seq;
+    rt_uint32_t dropped;        /* 时间戳已被覆盖的消息数 */
+    struct repack_hist hist;    /* 时间戳计数单位 */
+    rt_uint32_t stamps[RTREPACK_IPC_LATENCY_DEPTH];
+#ifdef RTREPACK_USING_IPC_TRACE
+    rt_uint32_t trace_ids[RTREPACK_IPC_LATENCY_DEPTH];  /* 与 stamps 同序号，0 表示未被采样 */
+#endif
+};
+
+static struct ipc_latency ipc_latency_table[RTREPACK_IPC_LATENCY_OBJECTS];
+
+static void ipc_latency_register(rt_object_t object)
+{
+    rt_uint8_t type = rt_object_get_type(object);
+    rt_base_t level;
+    rt_uint16_t i;
+
+    if (type != RT_Object_Class_MailBox && type != RT_Object_Class_MessageQueue)
+        return;
+    repack_timestamp_init();
+    level = rt_hw_interrupt_disable();
+    for (i = 0; i < RTREPACK_IPC_LATENCY_OBJECTS; i++)
+    {
+        if (ipc_latency_table[i].object == RT_NULL)
+        {
+            rt_memset(&ipc_latency_table[i], 0, sizeof(ipc_latency_table[i]));
+            repack_lock_init(&ipc_latency_table[i].lock);
+            ipc_latency_table[i].object = object;
+            break;
+        }
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+static void ipc_latency_unregister(rt_object_t object)
+{
+    rt_uint16_t i;
+
+    for (i = 0; i < RTREPACK_IPC_LATENCY_OBJECTS; i++)
+    {
+        if (ipc_latency_table[i].object == object)
+            ipc_latency_table[i].object = RT_NULL;
+    }
+}
+
+static struct ipc_latency *ipc_latency_find(const void *object)
+{
+    rt_uint16_t i;
+
+    for (i = 0; i < RTREPACK_IPC_LATENCY_OBJECTS; i++)
+    {
+        if (ipc_latency_table[i].object == (rt_object_t)object)
+            return &ipc_latency_table[i];
+    }
+    return RT_NULL;
+}
+
+#ifdef RTREPACK_USING_IPC_TRACE
+/*
+ * 跨流水线的链路追踪。
+ *
+ * 源头线程调用 `ipc_trace_begin` 按 1/RTREPACK_IPC_TRACE_SAMPLE 的比例为下一条工作开启追踪，
+ * 得到的追踪号成为该线程的当前上下文。带时间戳发送时，当前上下文随时间戳写入旁路环；
+ * 接收方取到带追踪号的消息时记录一跳（对象、接收线程、入队与出队时间），并把追踪号
+ * 作为自己的当前上下文，于是后续发送自动沿用；取到未被采样的消息则清空上下文。
+ * 终点线程调用 `ipc_trace_end` 结束追踪。上下文按线程登记编号保存，只有登记过的线程
+ * （`thread_generator` 创建的线程会自动登记）能够传递追踪号，中断中发送的消息不携带追踪号。
+ */
+#define IPC_TRACE_BEGIN 0
+#define IPC_TRACE_HOP   1
+#define IPC_TRACE_END   2
+
+struct ipc_trace_record
+{
+    rt_uint32_t trace_id;
+    rt_uint32_t enqueue;        /* 入队时间戳，起止记录为事件时间 */
+    rt_uint32_t dequeue;        /* 出队时间戳，起止记录为事件时间 */
+    rt_uint8_t kind;            /* IPC_TRACE_xxx */
+    rt_uint8_t thread;          /* 接收线程（起止记录为调用线程）的登记编号 */
+    char object[RT_NAME_MAX];   /* 经过的邮箱或消息队列名称 */
+};
+
+static struct
+{
+    rt_uint32_t context[RTREPACK_THREAD_REGISTRY_SIZE + 1];    /* 按线程登记编号保存的当前追踪号 */
+    rt_uint32_t next_id;
+    rt_uint32_t sample_count;
+    rt_uint32_t write;
+    struct ipc_trace_record records[RTREPACK_IPC_TRACE_RECORDS];
+} ipc_trace_ctx;
+
+/* 当前线程的上下文槽位；中断中或未登记线程返回 RT_NULL */
+static rt_uint32_t *ipc_trace_slot(void)
+{
+    rt_uint8_t id;
+
+    if (rt_interrupt_get_nest() > 0)
+        return RT_NULL;
+    id = repack_thread_id(rt_thread_self());
+    return id ? &ipc_trace_ctx.context[id] : RT_NULL;
+}
+
+static void ipc_trace_record_add(rt_uint32_t trace_id, rt_uint8_t kind, rt_object_t object,
+                                 rt_uint32_t enqueue, rt_uint32_t dequeue)
+{
+    struct ipc_trace_record *rec;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    rec = &ipc_trace_ctx.records[ipc_trace_ctx.write++ % RTREPACK_IPC_TRACE_RECORDS];
+    rec->trace_id = trace_id;
+    rec->kind = kind;
+    rec->thread = repack_thread_id(rt_thread_self());
+    rec->enqueue = enqueue;
+    rec->dequeue = dequeue;
+    if (object != RT_NULL)
+        rt_strncpy(rec->object, object->name, RT_NAME_MAX);
+    else
+        rec->object[0] = '\0';
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * @brief  在源头线程为接下来的一条工作开启追踪（按采样比例）。
+ *
+ * @return 追踪号；本次未被采样或当前线程未登记时返回 0，此时当前上下文被清空。
+ */
+rt_uint32_t ipc_trace_begin(void)
+{
+    rt_uint32_t *slot = ipc_trace_slot();
+    rt_uint32_t trace_id = 0;
+    rt_base_t level;
+
+    if (slot == RT_NULL)
+        return 0;
+    level = rt_hw_interrupt_disable();
+    if (ipc_trace_ctx.sample_count++ % RTREPACK_IPC_TRACE_SAMPLE == 0)
+    {
+        trace_id = ++ipc_trace_ctx.next_id;
+        if (trace_id == 0)
+            trace_id = ++ipc_trace_ctx.next_id;
+    }
+    rt_hw_interrupt_enable(level);
+    *slot = trace_id;
+    if (trace_id != 0)
+    {
+        rt_uint32_t now = repack_timestamp_get();
+
+        ipc_trace_record_add(trace_id, IPC_TRACE_BEGIN, RT_NULL, now, now);
+    }
+    return trace_id;
+}
+
+/**
+ * @brief  在终点线程结束当前追踪，记录终点时间并清空上下文。
+ */
+void ipc_trace_end(void)
+{
+    rt_uint32_t *slot = ipc_trace_slot();
+    rt_uint32_t now = repack_timestamp_get();
+
+    if (slot == RT_NULL || *slot == 0)
+        return;
+    ipc_trace_record_add(*slot, IPC_TRACE_END, RT_NULL, now, now);
+    *slot = 0;
+}
+
+/**
+ * @brief  当前线程的追踪号，0 表示没有正在追踪的工作。
+ */
+rt_uint32_t ipc_trace_current(void)
+{
+    rt_uint32_t *slot = ipc_trace_slot();
+
+    return slot ? *slot : 0;
+}
+#endif /* RTREPACK_USING_IPC_TRACE */
+
+/* 投递成功后在持有 lat->lock 的同一临界区内调用 */
+rt_inline void ipc_latency_on_send(struct ipc_latency *lat)
+{
+    rt_uint32_t index = lat->send_seq++ % RTREPACK_IPC_LATENCY_DEPTH;
+
+    lat->stamps[index] = repack_timestamp_get();
+#ifdef RTREPACK_USING_IPC_TRACE
+    lat->trace_ids[index] = ipc_trace_current();
+#endif
+}
+
+static void ipc_latency_on_recv(struct ipc_latency *lat)
+{
+    rt_uint32_t now = repack_timestamp_get();
+    rt_base_t level = repack_lock(&lat->lock);
+    rt_uint32_t seq = lat->recv_seq++;
+    rt_uint32_t stamp = 0;
+#ifdef RTREPACK_USING_IPC_TRACE
+    rt_uint32_t trace_id = 0;
+    rt_uint32_t *slot;
+#endif
+
+    if (lat->send_seq - seq > RTREPACK_IPC_LATENCY_DEPTH)
+        lat->dropped++;
+    else
+    {
+        stamp = lat->stamps[seq % RTREPACK_IPC_LATENCY_DEPTH];
+        repack_hist_add(&lat->hist, now - stamp);
+#ifdef RTREPACK_USING_IPC_TRACE
+        trace_id = lat->trace_ids[seq % RTREPACK_IPC_LATENCY_DEPTH];
+#endif
+    }
+    repack_unlock(&lat->lock, level);
+
+#ifdef RTREPACK_USING_IPC_TRACE
+    slot = ipc_trace_slot();
+    if (slot != RT_NULL)
+        *slot = trace_id;
+    if (trace_id != 0)
+        ipc_trace_record_add(trace_id, IPC_TRACE_HOP, lat->object, stamp, now);
+#endif
+}
+
+/**
+ * @brief 带时间戳的非阻塞邮件发送，可在中断中调用。
+ *
+ * @return 同 `rt_mb_send`，邮箱满时返回 `-RT_EFULL`。
+ */
+rt_err_t mailbox_send_stamped(rt_mailbox_t mb, rt_ubase_t value)
+{
+    struct ipc_latency *lat = ipc_latency_find(mb);
+    rt_base_t level;
+    rt_err_t ret;
+
+    if (lat == RT_NULL)
+        return rt_mb_send(mb, value);
+    level = repack_lock(&lat->lock);
+    ret = rt_mb_send(mb, value);
+    if (ret == RT_EOK)
+        ipc_latency_on_send(lat);
+    repack_unlock(&lat->lock, level);
+    return ret;
+}
+
+/**
+ * @brief 接收邮件并记录其排队时间，参数与返回值同 `rt_mb_recv`。
+ */
+rt_err_t mailbox_recv_stamped(rt_mailbox_t mb, rt_ubase_t *value, rt_int32_t timeout)
+{
+    struct ipc_latency *lat = ipc_latency_find(mb);
+    rt_err_t ret = rt_mb_recv(mb, value, timeout);
+
+    if (ret == RT_EOK && lat != RT_NULL)
+        ipc_latency_on_recv(lat);
+    return ret;
+}
+
+/**
+ * @brief 带时间戳的非阻塞消息发送，可在中断中调用。
+ *
+ * @return 同 `rt_mq_send`，队列满时返回 `-RT_EFULL`。
+ */
+rt_err_t mq_send_stamped(rt_mq_t mq, const void *buffer, rt_size_t size)
+{
+    struct ipc_latency *lat = ipc_latency_find(mq);
+    rt_base_t level;
+    rt_err_t ret;
+
+    if (lat == RT_NULL)
+        return rt_mq_send(mq, buffer, size);
+    level = repack_lock(&lat->lock);
+    ret = rt_mq_send(mq, buffer, size);
+    if (ret == RT_EOK)
+        ipc_latency_on_send(lat);
+    repack_unlock(&lat->lock, level);
+    return ret;
+}
+
+/**
+ * @brief 接收消息并记录其排队时间。
+ *
+ * @return 成功时返回非负值（5.x 为消息长度，4.x 为 `RT_EOK`），失败时返回负的错误码。
+ */
+rt_int32_t mq_recv_stamped(rt_mq_t mq, void *buffer, rt_size_t size, rt_int32_t timeout)
+{
+    struct ipc_latency *lat = ipc_latency_find(mq);
+    rt_int32_t ret = (rt_int32_t)rt_mq_recv(mq, buffer, size, timeout);
+
+    if (ret >= 0 && lat != RT_NULL)
+        ipc_latency_on_recv(lat);
+    return ret;
+}
+
+/**
+ * @brief  输出各对象的排队延迟统计。
+ *
+ * 每个对象一行：`latency,<name>,<depth>,<count>,<dropped>,<p50_us>,<p99_us>,<max_us>`。
+ *
+ * @param[in] reset  输出后是否清零统计。
+ */
+void ipc_latency_dump(rt_bool_t reset)
+{
+    rt_uint32_t freq = repack_timestamp_freq();
+    struct repack_hist hist;
+    rt_uint32_t dropped;
+    rt_uint16_t i, depth;
+    rt_base_t level;
+
+    rt_kprintf("latency,name,depth,count,dropped,p50_us,p99_us,max_us\n");
+    for (i = 0; i < RTREPACK_IPC_LATENCY_OBJECTS; i++)
+    {
+        struct ipc_latency *lat = &ipc_latency_table[i];
+
+        if (lat->object == RT_NULL)
+            continue;
+        level = repack_lock(&lat->lock);
+        hist = lat->hist;
+        dropped = lat->dropped;
+        if (reset)
+        {
+            rt_memset(&lat->hist, 0, sizeof(lat->hist));
+            lat->dropped = 0;
+        }
+        repack_unlock(&lat->lock, level);
+        depth = (rt_object_get_type(lat->object) == RT_Object_Class_MailBox) ? mailbox_depth((rt_mailbox_t)lat->object)
+                                                                                : mq_depth((rt_mq_t)lat->object);
+        rt_kprintf("latency,%.*s,%d,%d,%d,%d,%d,%d\n", RT_NAME_MAX, lat->object->name, depth, hist.count, dropped,
+                   repack_timestamp_to_us(repack_hist_percentile(&hist, 500), freq),
+                   repack_timestamp_to_us(repack_hist_percentile(&hist, 990), freq),
+                   repack_timestamp_to_us(hist.max, freq));
+    }
+}
+
+#ifdef RTREPACK_USING_IPC_TRACE
+static const char *ipc_trace_thread_name(rt_uint8_t id)
+{
+    if (id == 0 || repack_threads[id - 1] == RT_NULL)
+        return "-";
+    return repack_threads[id - 1]->name;
+}
+
+/**
+ * @brief  按追踪输出记录缓冲区中完整保留了起点的各条链路。
+ *
+ * 每一跳一行：`trace,<id>,<hop>,<object>,<thread>,<service_us>,<queue_us>`。
+ * hop 为 0 的行是起点；service_us 为上一跳线程从取到消息到发出本跳消息所用的时间，
+ * queue_us 为本跳的排队时间；hop 为 `end` 的行的 service_us 是终点线程的处理时间，
+ * 随后一行 `trace,<id>,total,,,<total_us>,` 给出端到端耗时。
+ *
+ * @note  输出期间新记录可能覆盖旧记录，宜在停止流量或采样较稀疏时调用。
+ */
+void ipc_trace_dump(void)
+{
+    rt_uint32_t freq = repack_timestamp_freq();
+    rt_uint32_t write = ipc_trace_ctx.write;
+    rt_uint32_t first = (write > RTREPACK_IPC_TRACE_RECORDS) ? write - RTREPACK_IPC_TRACE_RECORDS : 0;
+    rt_uint32_t i, j;
+
+    rt_kprintf("trace,id,hop,object,thread,service_us,queue_us\n");
+    for (i = first; i < write; i++)
+    {
+        const struct ipc_trace_record *begin = &ipc_trace_ctx.records[i % RTREPACK_IPC_TRACE_RECORDS];
+        rt_uint32_t last = begin->dequeue;
+        rt_uint16_t hop = 0;
+
+        if (begin->kind != IPC_TRACE_BEGIN)
+            continue;
+        rt_kprintf("trace,%d,0,-,%.*s,0,0\n", begin->trace_id, RT_NAME_MAX, ipc_trace_thread_name(begin->thread));
+        for (j = i + 1; j < write; j++)
+        {
+            const struct ipc_trace_record *rec = &ipc_trace_ctx.records[j % RTREPACK_IPC_TRACE_RECORDS];
+
+            if (rec->trace_id != begin->trace_id)
+                continue;
+            if (rec->kind == IPC_TRACE_HOP)
+            {
+                rt_kprintf("trace,%d,%d,%.*s,%.*s,%d,%d\n", rec->trace_id, ++hop, RT_NAME_MAX, rec->object,
+                           RT_NAME_MAX, ipc_trace_thread_name(rec->thread),
+                           repack_timestamp_to_us(rec->enqueue - last, freq),
+                           repack_timestamp_to_us(rec->dequeue - rec->enqueue, freq));
+                last = rec->dequeue;
+            }
+            else if (rec->kind == IPC_TRACE_END)
+            {
+                rt_kprintf("trace,%d,end,-,%.*s,%d,0\n", rec->trace_id, RT_NAME_MAX,
+                           ipc_trace_thread_name(rec->thread), repack_timestamp_to_us(rec->dequeue - last, freq));
+                rt_kprintf("trace,%d,total,,,%d,\n", rec->trace_id,
+                           repack_timestamp_to_us(rec->dequeue - begin->dequeue, freq));
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief  清空追踪记录。
+ */
+void ipc_trace_clear(void)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+
+    ipc_trace_ctx.write = 0;
+    rt_hw_interrupt_enable(level);
+}
+#endif /* RTREPACK_USING_IPC_TRACE */
+
+#ifdef RT_USING_FINSH
+static int ipc_latency(int argc, char **argv)
+{
+    ipc_latency_dump((argc >= 2 && !rt_strncmp(argv[1], "reset", 5)) ? RT_TRUE : RT_FALSE);
+    return 0;
+}
+MSH_CMD_EXPORT(ipc_latency, queueing delay per mailbox and message queue [reset]);
+#ifdef RTREPACK_USING_IPC_TRACE
+static int ipc_trace(int argc, char **argv)
+{
+    if (argc >= 2 && !rt_strncmp(argv[1], "clear", 5))
+        ipc_trace_clear();
+    else
+        ipc_trace_dump();
+    return 0;
+}
+MSH_CMD_EXPORT(ipc_trace, per-hop latency of sampled pipeline traces [clear]);
+#endif
+#endif /* RT_USING_FINSH */
+#else
+rt_inline rt_err_t mailbox_send_stamped(rt_mailbox_t mb, rt_ubase_t value)
+{
+    return rt_mb_send(mb, value);
+}
+
+rt_inline rt_err_t mailbox_recv_stamped(rt_mailbox_t mb, rt_ubase_t *value, rt_int32_t timeout)
+{
+    return rt_mb_recv(mb, value, timeout);
+}
+
+rt_inline rt_err_t mq_send_stamped(rt_mq_t mq, const void *buffer, rt_size_t size)
+{
+    return rt_mq_send(mq, buffer, size);
+}
+
+rt_inline rt_int32_t mq_recv_stamped(rt_mq_t mq, void *buffer, rt_size_t size, rt_int32_t timeout)
+{
+    return (rt_int32_t)rt_mq_recv(mq, buffer, size, timeout);
+}
+#endif /* RTREPACK_USING_IPC_LATENCY */
+
+#ifdef RTREPACK_USING_BALANCER
+/*
+ * SMP 负载均衡。
+ *
+ * 调度器钩子在每次切换时把上一段运行时间记到被切出线程与所在核上（只统计已登记的线程，
+ * 各核空闲线程不计入核负载）；均衡线程每个周期取出这些计数，按指数滑动平均得到
+ * 各核与各线程的负载（千分比）。最忙核与最闲核的负载差连续 RTREPACK_BALANCE_PERSIST 个周期
+ * 超过 RTREPACK_BALANCE_THRESHOLD 时，从最忙核上挑一个可迁移的线程绑定到最闲核：
+ * 只考虑未被用户绑核的线程，负载不超过差值的一半（迁移后不会反向失衡），且距上次迁移
+ * 已超过 RTREPACK_BALANCE_COOLDOWN 个周期，以免缓存热的线程被来回搬动。
+ *
+ * 运行时间用 repack_timestamp_get 计量，SMP 平台一般没有 DWT，应通过 RTREPACK_TIMESTAMP_GET
+ * 提供各核一致的高分辨率计数器，否则只有节拍分辨率。
+ */
+struct balancer_thread
+{
+    rt_thread_t thread;             /* 登记表中该编号对应的线程，编号被复用时据此清零 */
+    volatile rt_uint32_t run;       /* 本周期运行时间，钩子累加，均衡线程取走 */
+    rt_uint16_t load;               /* 负载千分比（滑动平均） */
+    rt_uint8_t cpu;                 /* 最近运行所在核 */
+    rt_uint8_t bound;               /* 均衡器为其绑定的核，RT_CPUS_NR 表示未绑定 */
+    rt_uint32_t moved_at;           /* 上次迁移时的周期序号 */
+};
+
+static struct
+{
+    rt_uint32_t last_switch[RTREPACK_CPUS_NR];      /* 各核上次切换时间，仅本核钩子访问 */
+    volatile rt_uint32_t busy[RTREPACK_CPUS_NR];    /* 本周期各核非空闲时间 */
+    rt_uint16_t cpu_load[RTREPACK_CPUS_NR];         /* 各核负载千分比（滑动平均） */
+    struct balancer_thread threads[RTREPACK_THREAD_REGISTRY_SIZE + 1];
+    rt_uint32_t period;
+    rt_uint32_t window_start;
+    rt_uint8_t imbalance_runs;
+    rt_uint32_t migrations;
+    struct rt_thread thread;
+    rt_uint8_t stack[1024];
+    struct rt_semaphore exited; /* 均衡线程退出循环后释放，`balancer_stop` 在此等待 */
+    volatile rt_bool_t running;
+} balancer_ctx;
+
+static void balancer_sched_hook(struct rt_thread *from, struct rt_thread *to)
+{
+    rt_uint8_t cpu = repack_cpu_id();
+    rt_uint32_t now = repack_timestamp_get();
+    rt_uint32_t delta = now - balancer_ctx.last_switch[cpu];
+    rt_uint8_t id;
+
+    (void)to;
+    balancer_ctx.last_switch[cpu] = now;
+    // 钩子在发生切换的核上执行，from 是本核的空闲线程时这段时间不计入负载
+    if (from == rt_thread_idle_gethandler())
+        return;
+    repack_atomic_add(&balancer_ctx.busy[cpu], delta);
+    id = repack_thread_id(from);
+    if (id != 0)
+    {
+        repack_atomic_add(&balancer_ctx.threads[id].run, delta);
+        balancer_ctx.threads[id].cpu = cpu;
+    }
+}
+
+/* 新值占 1/4 的滑动平均 */
+rt_inline rt_uint16_t balancer_ewma(rt_uint16_t average, rt_uint32_t sample)
+{
+    if (sample > 1000)
+        sample = 1000;
+    return (rt_uint16_t)((average * 3 + sample) / 4);
+}
+
+/* 线程可迁移：已登记、仍存活，且未被用户绑核（或只绑在均衡器选定的核上） */
+static rt_bool_t balancer_movable(const struct balancer_thread *bt)
+{
+    rt_uint8_t bind_cpu;
+
+    if (bt->thread == RT_NULL)
+        return RT_FALSE;
+    bind_cpu = repack_thread_bind_cpu(bt->thread);
+    return (bind_cpu == RT_CPUS_NR || bind_cpu == bt->bound) ? RT_TRUE : RT_FALSE;
+}
+
+static void balancer_update(void)
+{
+    rt_uint32_t now = repack_timestamp_get();
+    rt_uint32_t window = now - balancer_ctx.window_start;
+    rt_uint8_t cpu, id;
+
+    balancer_ctx.window_start = now;
+    if (window == 0)
+        window = 1;
+    for (cpu = 0; cpu < RTREPACK_CPUS_NR; cpu++)
+    {
+        rt_uint32_t busy = repack_atomic_xchg(&balancer_ctx.busy[cpu], 0);
+
+        balancer_ctx.cpu_load[cpu] = balancer_ewma(balancer_ctx.cpu_load[cpu],
+                                                   (rt_uint32_t)((rt_uint64_t)busy * 1000 / window));
+    }
+    for (id = 1; id <= RTREPACK_THREAD_REGISTRY_SIZE; id++)
+    {
+        struct balancer_thread *bt = &balancer_ctx.threads[id];
+        rt_uint32_t run = repack_atomic_xchg(&bt->run, 0);
+
+        if (bt->thread != repack_threads[id - 1])
+        {
+            bt->thread = repack_threads[id - 1];
+            bt->load = 0;
+            bt->bound = RT_CPUS_NR;
+            bt->moved_at = 0;
+        }
+        bt->load = balancer_ewma(bt->load, (rt_uint32_t)((rt_uint64_t)run * 1000 / window));
+    }
+}
+
+static void balancer_rebalance(void)
+{
+    rt_uint8_t cpu, id, busiest = 0, idlest = 0;
+    struct balancer_thread *pick = RT_NULL;
+    rt_uint16_t gap;
+
+    for (cpu = 1; cpu < RTREPACK_CPUS_NR; cpu++)
+    {
+        if (balancer_ctx.cpu_load[cpu] > balancer_ctx.cpu_load[busiest])
+            busiest = cpu;
+        if (balancer_ctx.cpu_load[cpu] < balancer_ctx.cpu_load[idlest])
+            idlest = cpu;
+    }
+    gap = balancer_ctx.cpu_load[busiest] - balancer_ctx.cpu_load[idlest];
+    if (gap <= RTREPACK_BALANCE_THRESHOLD)
+    {
+        balancer_ctx.imbalance_runs = 0;
+        return;
+    }
+    if (++balancer_ctx.imbalance_runs < RTREPACK_BALANCE_PERSIST)
+        return;
+
+    for (id = 1; id <= RTREPACK_THREAD_REGISTRY_SIZE; id++)
+    {
+        struct balancer_thread *bt = &balancer_ctx.threads[id];
+
+        if (!balancer_movable(bt) || bt->cpu != busiest || bt->load == 0 || bt->load > gap / 2)
+            continue;
+        if (bt->moved_at != 0 && balancer_ctx.period - bt->moved_at < RTREPACK_BALANCE_COOLDOWN)
+            continue;
+        if (pick == RT_NULL || bt->load > pick->load)
+            pick = bt;
+    }
+    if (pick == RT_NULL)
+        return;
+
+    rt_thread_control(pick->thread, RT_THREAD_CTRL_BIND_CPU, (void *)(rt_ubase_t)idlest);
+    LOG_D("balancer: %.*s cpu%d -> cpu%d (load %d, gap %d)\n", RT_NAME_MAX, pick->thread->name, busiest, idlest,
+          pick->load, gap);
+    pick->bound = idlest;
+    pick->cpu = idlest;
+    pick->moved_at = balancer_ctx.period;
+    // 预估迁移后的负载，避免下个周期在滑动平均尚未跟上时重复迁移
+    balancer_ctx.cpu_load[busiest] -= pick->load;
+    balancer_ctx.cpu_load[idlest] += pick->load;
+    balancer_ctx.imbalance_runs = 0;
+    balancer_ctx.migrations++;
+}
+
+static void balancer_entry(void *parameter)
+{
+    (void)parameter;
+    while (balancer_ctx.running)
+    {
+        rt_thread_mdelay(RTREPACK_BALANCE_PERIOD);
+        balancer_ctx.period++;
+        balancer_update();
+        balancer_rebalance();
+    }
+    rt_sem_release(&balancer_ctx.exited);
+}
+
+/**
+ * @brief  启动负载均衡线程。
+ *
+ * @param[in] priority  均衡线程优先级，宜高于被均衡的工作线程以保证周期稳定。
+ *
+ * @return `RT_EOK` 表示成功，`-RT_EBUSY` 表示正在运行或上一次的均衡线程尚未被内核回收，
+ *         其他值为线程创建失败。
+ */
+rt_err_t balancer_start(rt_uint8_t priority)
+{
+    rt_thread_t thread = &balancer_ctx.thread;
+    rt_uint8_t id;
+    rt_err_t ret;
+
+    if (balancer_ctx.running || repack_thread_listed(thread))
+        return -RT_EBUSY;
+    rt_sem_init(&balancer_ctx.exited, "balx", 0, RT_IPC_FLAG_FIFO);
+    rt_memset(balancer_ctx.cpu_load, 0, sizeof(balancer_ctx.cpu_load));
+    for (id = 0; id <= RTREPACK_THREAD_REGISTRY_SIZE; id++)
+    {
+        rt_memset(&balancer_ctx.threads[id], 0, sizeof(balancer_ctx.threads[id]));
+        balancer_ctx.threads[id].bound = RT_CPUS_NR;
+    }
+    balancer_ctx.period = 0;
+    balancer_ctx.imbalance_runs = 0;
+    balancer_ctx.running = RT_TRUE;
+
+    ret = thread_generator(&thread, "balance", balancer_entry, RT_NULL, balancer_ctx.stack,
+                           sizeof(balancer_ctx.stack), priority, 10, RT_FALSE);
+    if (ret != RT_EOK)
+    {
+        balancer_ctx.running = RT_FALSE;
+        rt_sem_detach(&balancer_ctx.exited);
+        return ret;
+    }
+    repack_timestamp_init();
+    balancer_ctx.window_start = repack_timestamp_get();
+    for (id = 0; id < RTREPACK_CPUS_NR; id++)
+        balancer_ctx.last_switch[id] = balancer_ctx.window_start;
+    repack_sched_hook_set(REPACK_SCHED_HOOK_BALANCER, balancer_sched_hook);
+    rt_thread_startup(thread);
+    return RT_EOK;
+}
+
+/**
+ * @brief  停止负载均衡，等待均衡线程退出后返回（最长一个均衡周期），已做的绑核保持不变。不能在中断中调用。
+ */
+void balancer_stop(void)
+{
+    if (!balancer_ctx.running)
+        return;
+    repack_sched_hook_set(REPACK_SCHED_HOOK_BALANCER, RT_NULL);
+    balancer_ctx.running = RT_FALSE;
+    rt_sem_take(&balancer_ctx.exited, RT_WAITING_FOREVER);
+    rt_sem_detach(&balancer_ctx.exited);
+}
+
+/**
+ * @brief  输出各核与各线程的负载。
+ *
+ * 每核一行 `balance,cpu,<cpu>,<load_permille>`，每个已登记线程一行
+ * `balance,thread,<name>,<cpu>,<load_permille>,<pinned>`，pinned 为 1 表示被用户绑核、不参与迁移。
+ */
+void balancer_dump(void)
+{
+    rt_uint8_t cpu, id;
+
+    rt_kprintf("balance,# periods %d, migrations %d\n", balancer_ctx.period, balancer_ctx.migrations);
+    for (cpu = 0; cpu < RTREPACK_CPUS_NR; cpu++)
+        rt_kprintf("balance,cpu,%d,%d\n", cpu, balancer_ctx.cpu_load[cpu]);
+    for (id = 1; id <= RTREPACK_THREAD_REGISTRY_SIZE; id++)
+    {
+        const struct balancer_thread *bt = &balancer_ctx.threads[id];
+
+        if (bt->thread == RT_NULL)
+            continue;
+        rt_kprintf("balance,thread,%.*s,%d,%d,%d\n", RT_NAME_MAX, bt->thread->name, bt->cpu, bt->load,
+                   balancer_movable(bt) ? 0 : 1);
+    }
+}
+
+#ifdef RT_USING_FINSH
+static int balancer(int argc, char **argv)
+{
+    if (argc >= 2 && !rt_strncmp(argv[1], "start", 5))
+        return balancer_start(RT_THREAD_PRIORITY_MAX / 4);
+    if (argc >= 2 && !rt_strncmp(argv[1], "stop", 4))
+        balancer_stop();
+    else if (argc >= 2 && !rt_strncmp(argv[1], "dump", 4))
+        balancer_dump();
+    else
+        rt_kprintf("usage: balancer start|stop|dump\n");
+    return 0;
+}
+MSH_CMD_EXPORT(balancer, SMP load-based thread migration);
+#endif /* RT_USING_FINSH */
+#endif /* RTREPACK_USING_BALANCER */
+
+/* ---------------------------- 可选功能的对象登记 ---------------------------- */
+
+#ifdef RT_USING_HOOK
+/* 对象脱离/删除时撤销各功能的登记 */
+static void repack_object_detached(struct rt_object *object)
+{
+    if (rt_object_get_type(object) == RT_Object_Class_Thread)
+        coop_thread_detached((rt_thread_t)object);
+#ifdef RTREPACK_USING_STATIC_POOLS
+    repack_pool_release(object);
+#endif
+#ifdef RTREPACK_USING_HEAP_MONITOR
+    heap_monitor_untag(object);
+#endif
+#ifdef RTREPACK_USING_IPC_CAPTURE
+    ipc_capture_unregister(object);
+#endif
+#ifdef RTREPACK_USING_IPC_LATENCY
+    ipc_latency_unregister(object);
+#endif
+#ifdef RTREPACK_USING_THREAD_REGISTRY
+    if (rt_object_get_type(object) == RT_Object_Class_Thread)
+        repack_thread_unregister((rt_thread_t)object);
+#endif
+}
+
+/* 首次创建或登记对象（或初始化协作调度组）时安装脱离钩子 */
+static void repack_detach_hook_install(void)
+{
+    static rt_bool_t hooked = RT_FALSE;
+
+    if (!hooked)
+    {
+        rt_object_detach_sethook(repack_object_detached);
+        hooked = RT_TRUE;
+    }
+}
+#endif /* RT_USING_HOOK */
+
+static void repack_object_created(rt_object_t object, rt_bool_t is_dynamic)
+{
+#ifdef RTREPACK_USING_DETACH_HOOK
+    repack_detach_hook_install();
+#endif
+#ifdef RTREPACK_USING_HEAP_MONITOR
+    if (is_dynamic)
+        heap_monitor_tag_object(object);
+#endif
+#ifdef RTREPACK_USING_IPC_CAPTURE
+    ipc_capture_register(object);
+#endif
+#ifdef RTREPACK_USING_IPC_LATENCY
+    ipc_latency_register(object);
+#endif
+#ifdef RTREPACK_USING_THREAD_REGISTRY
+    if (rt_object_get_type(object) == RT_Object_Class_Thread)
+        repack_thread_register((rt_thread_t)object);
+#endif
+    (void)object;
+    (void)is_dynamic;
+}
+
 #endif
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Plot the output of `bench_contention_sweep` / msh `bench_sweep`.
+
+Usage: bench_plot.py console.log [-o out.png]
+
+Every line starting with "bench," is parsed; other console output is ignored.
+One column of subplots per primitive: throughput on top, p99 latency below,
+x axis is producers + consumers, one curve per (cpus, producers) pair.
+"""
+import argparse
+import collections
+import sys
+
+import matplotlib.pyplot as plt
+
+FIELDS = ("kind", "cpus", "producers", "consumers", "ops_per_sec", "p50_us", "p99_us", "max_us")
+
+
+def parse(path):
+    rows = []
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith("bench,") or line.startswith("bench,kind"):
+                continue
+            values = line.split(",")[1:]
+            if len(values) != len(FIELDS):
+                continue
+            row = dict(zip(FIELDS, values))
+            for key in FIELDS[1:]:
+                row[key] = int(row[key])
+            rows.append(row)
+    return rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("log")
+    parser.add_argument("-o", "--output", help="write an image instead of opening a window")
+    args = parser.parse_args()
+
+    rows = parse(args.log)
+    if not rows:
+        sys.exit("no bench lines found in %s" % args.log)
+
+    kinds = list(collections.OrderedDict.fromkeys(r["kind"] for r in rows))
+    fig, axes = plt.subplots(2, len(kinds), figsize=(4 * len(kinds), 7), squeeze=False)
+    for col, kind in enumerate(kinds):
+        curves = collections.defaultdict(list)
+        for r in rows:
+            if r["kind"] == kind:
+                curves[(r["cpus"], r["producers"])].append(r)
+        for (cpus, producers), points in sorted(curves.items()):
+            points.sort(key=lambda r: r["consumers"])
+            x = [r["producers"] + r["consumers"] for r in points]
+            label = "%d cpu, %d prod" % (cpus, producers)
+            axes[0][col].plot(x, [r["ops_per_sec"] for r in points], marker="o", label=label)
+            axes[1][col].plot(x, [r["p99_us"] for r in points], marker="o", label=label)
+        axes[0][col].set_title(kind)
+        axes[0][col].set_ylabel("ops/s")
+        axes[1][col].set_ylabel("p99 latency (us)")
+        axes[1][col].set_xlabel("threads (producers + consumers)")
+        for ax in (axes[0][col], axes[1][col]):
+            ax.set_xscale("log", base=2)
+            ax.grid(True, alpha=0.3)
+        axes[0][col].legend(fontsize="x-small")
+
+    fig.tight_layout()
+    if args.output:
+        fig.savefig(args.output, dpi=120)
+    else:
+        plt.show()
+
+
+if __name__ == "__main__":
+    main()
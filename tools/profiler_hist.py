@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Turn `profiler_dump` output into a flat per-function sample histogram.
+
+Usage: profiler_hist.py console.log firmware.elf [--addr2line TOOL] [--by-thread]
+       profiler_hist.py console.log firmware.elf --folded > out.folded
+
+Each `prof,<thread>,<pc>,<count>` line is resolved with addr2line and the
+counts are summed per function (self time only). The sampler records the
+interrupted PC and nothing else: there is no unwind, so callers never get
+credit for time spent in their callees. A pc of 0 means the sample came
+from a nested interrupt or from a port without PC capture and is reported
+as [unknown].
+
+--folded prints `thread;function count` lines for flamegraph.pl /
+speedscope. The result is still the same flat histogram, just one level
+per thread; it is not a call-stack flame graph.
+"""
+import argparse
+import collections
+import subprocess
+import sys
+
+UNKNOWN = "[unknown]"
+
+
+def parse(path):
+    samples = collections.Counter()
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith("prof,") or line.startswith("prof,#"):
+                continue
+            parts = line.split(",")
+            if len(parts) != 4:
+                continue
+            _, thread, pc, count = parts
+            samples[(thread, int(pc, 16))] += int(count)
+    return samples
+
+
+def resolve(elf, tool, pcs):
+    """Map each pc to the name of the function containing it."""
+    result = {}
+    pcs = sorted(pcs)
+    if not pcs:
+        return result
+    cmd = [tool, "-f", "-C", "-e", elf] + ["0x%x" % (pc & ~1) for pc in pcs]
+    out = subprocess.run(cmd, stdout=subprocess.PIPE, universal_newlines=True, check=True).stdout
+    lines = out.splitlines()
+    for n, pc in enumerate(pcs):
+        name = lines[2 * n] if 2 * n < len(lines) else "??"
+        result[pc] = name if name != "??" else "0x%x" % pc
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("log")
+    parser.add_argument("elf")
+    parser.add_argument("--addr2line", default="arm-none-eabi-addr2line")
+    parser.add_argument("--by-thread", action="store_true", help="keep one row per (thread, function)")
+    parser.add_argument("--folded", action="store_true", help="print thread;function lines for flamegraph.pl")
+    args = parser.parse_args()
+
+    samples = parse(args.log)
+    if not samples:
+        sys.exit("no prof lines found in %s" % args.log)
+    symbols = resolve(args.elf, args.addr2line, {pc for _, pc in samples if pc})
+
+    hist = collections.Counter()
+    for (thread, pc), count in samples.items():
+        function = symbols.get(pc, UNKNOWN) if pc else UNKNOWN
+        if args.folded:
+            hist["%s;%s" % (thread, function)] += count
+        elif args.by_thread:
+            hist["%-10s %s" % (thread, function)] += count
+        else:
+            hist[function] += count
+
+    if args.folded:
+        for stack, count in sorted(hist.items()):
+            print("%s %d" % (stack, count))
+        return
+    total = sum(hist.values())
+    print("%8s %6s  %s" % ("samples", "%", "function"))
+    for key, count in hist.most_common():
+        print("%8d %6.2f  %s" % (count, 100.0 * count / total, key))
+
+
+if __name__ == "__main__":
+    main()
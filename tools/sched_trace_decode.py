@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Decode a logic-analyzer capture of the `sched_trace_start` GPIO markers into
+per-thread timelines.
+
+Usage: sched_trace_decode.py capture.csv [-m console.log] [-n BITS]
+                             [--timeline out.csv] [--chrome out.json]
+
+capture.csv is a digital CSV export (sigrok-cli -O csv, Saleae "digital.csv",
+...): the first column is the sample/transition time in seconds, the next
+BITS columns are the marker pins, LSB (pins[0]) first. Header rows are skipped.
+
+console.log is the device console containing the `sched_trace,<code>,<name>`
+lines printed by `sched_trace_dump_map`; without it threads are shown by code.
+
+Prints a per-thread summary (run time, share, number of slices). --timeline
+writes every slice as CSV, --chrome writes a trace viewable in
+chrome://tracing or Perfetto.
+"""
+import argparse
+import collections
+import csv
+import json
+import sys
+
+
+def load_map(path):
+    names = {}
+    if not path:
+        return names
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("sched_trace,"):
+                _, code, name = line.split(",", 2)
+                names[int(code)] = name
+    return names
+
+
+def load_samples(path, bits):
+    samples = []
+    with open(path, newline="") as f:
+        for row in csv.reader(f):
+            if len(row) < bits + 1:
+                continue
+            try:
+                t = float(row[0])
+                code = 0
+                for i in range(bits):
+                    if int(float(row[1 + i])):
+                        code |= 1 << i
+            except ValueError:
+                continue
+            samples.append((t, code))
+    return samples
+
+
+def slices(samples):
+    """Collapse samples into (start, end, code) runs."""
+    out = []
+    if not samples:
+        return out
+    start, code = samples[0]
+    for t, c in samples[1:]:
+        if c != code:
+            out.append((start, t, code))
+            start, code = t, c
+    out.append((start, samples[-1][0], code))
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture")
+    parser.add_argument("-m", "--map", help="console log with sched_trace map lines")
+    parser.add_argument("-n", "--bits", type=int, default=4, help="number of marker pins (default 4)")
+    parser.add_argument("--timeline", help="write slices as CSV")
+    parser.add_argument("--chrome", help="write a Chrome trace-event JSON file")
+    args = parser.parse_args()
+
+    names = load_map(args.map)
+    runs = slices(load_samples(args.capture, args.bits))
+    if not runs:
+        sys.exit("no samples decoded from %s" % args.capture)
+
+    def name(code):
+        return names.get(code, "code%d" % code)
+
+    total = runs[-1][1] - runs[0][0]
+    busy = collections.defaultdict(float)
+    count = collections.Counter()
+    for start, end, code in runs:
+        busy[code] += end - start
+        count[code] += 1
+
+    print("%-12s %12s %8s %8s" % ("thread", "time_ms", "share", "slices"))
+    for code in sorted(busy, key=busy.get, reverse=True):
+        share = busy[code] / total * 100 if total else 0.0
+        print("%-12s %12.3f %7.2f%% %8d" % (name(code), busy[code] * 1e3, share, count[code]))
+
+    if args.timeline:
+        with open(args.timeline, "w", newline="") as f:
+            w = csv.writer(f)
+            w.writerow(["start_s", "end_s", "code", "thread"])
+            for start, end, code in runs:
+                w.writerow(["%.9f" % start, "%.9f" % end, code, name(code)])
+
+    if args.chrome:
+        events = [{"name": name(code), "ph": "X", "pid": 0, "tid": code,
+                   "ts": start * 1e6, "dur": (end - start) * 1e6} for start, end, code in runs]
+        events += [{"name": "thread_name", "ph": "M", "pid": 0, "tid": code,
+                    "args": {"name": name(code)}} for code in busy]
+        with open(args.chrome, "w") as f:
+            json.dump({"traceEvents": events}, f)
+
+
+if __name__ == "__main__":
+    main()